@@ -0,0 +1,488 @@
+// Сквозной бенчмарк отчета на синтетических данных: CreateReport целиком и отдельные этапы.
+// Запуск: DailyTradesBenchmark [--sizes 10000,1000000] [--reps 5] [--groups 20]
+//         [--accounts 10000] [--skew 2.0] [--open-ratio 0.1] [--latency-us 0] [--top 10]
+//         [--verbose]
+// Случай 10M сделок: --sizes 10000,1000000,10000000
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MockServer.h"
+#include "services/AccountCache.h"
+#include "services/GroupIndex.h"
+#include "services/RateTable.h"
+#include "services/ThreadPool.h"
+#include "structures/TradeColumns.h"
+#include "utils/Aggregation.h"
+#include "utils/DayBucketer.h"
+#include "utils/SimdKernels.h"
+#include "utils/Utils.h"
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+extern "C" void CreateReport(rapidjson::Value&                   request,
+                             rapidjson::Value&                   response,
+                             rapidjson::Document::AllocatorType& allocator,
+                             CServerInterface*                   server);
+
+extern "C" void DestroyReport();
+
+extern "C" void ExportReport(rapidjson::Value&                   request,
+                             rapidjson::Value&                   response,
+                             rapidjson::Document::AllocatorType& allocator,
+                             CServerInterface*                   server);
+
+extern "C" void
+OnTradeEvent(EventRecordType record_type, const TradeRecord& trade, CServerInterface* server);
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchmarkOptions {
+        // 10M сделок по умолчанию не запускаются: мок и выборка отчета держат ~7 ГБ записей
+        // TradeRecord (344 байта каждая); этот размер задается явно через --sizes
+        std::vector<size_t> sizes{10000, 1000000};
+        int                 reps       = 5;
+        int                 top_count  = 10;
+        bool                is_verbose = false;
+        SyntheticConfig     synthetic;
+    };
+
+    std::vector<size_t> ParseSizes(const std::string& value) {
+        std::vector<size_t> sizes;
+        size_t              position = 0;
+
+        while (position < value.size()) {
+            const size_t comma = std::min(value.find(',', position), value.size());
+            sizes.push_back(std::stoull(value.substr(position, comma - position)));
+            position = comma + 1;
+        }
+
+        return sizes;
+    }
+
+    BenchmarkOptions ParseOptions(int argc, char** argv) {
+        BenchmarkOptions options;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name  = argv[i];
+            const std::string      value = i + 1 < argc ? argv[i + 1] : "";
+
+            if (name == "--verbose") {
+                options.is_verbose = true;
+                continue;
+            }
+
+            if (name == "--sizes") {
+                options.sizes = ParseSizes(value);
+            } else if (name == "--reps") {
+                options.reps = std::max(1, std::stoi(value));
+            } else if (name == "--groups") {
+                options.synthetic.groups_count = std::max(1, std::stoi(value));
+            } else if (name == "--accounts") {
+                options.synthetic.accounts_count = std::max(1, std::stoi(value));
+            } else if (name == "--skew") {
+                options.synthetic.login_skew = std::stod(value);
+            } else if (name == "--open-ratio") {
+                options.synthetic.open_trades_ratio = std::stod(value);
+            } else if (name == "--latency-us") {
+                options.synthetic.call_latency = std::chrono::microseconds(std::stol(value));
+            } else if (name == "--top") {
+                options.top_count = std::stoi(value);
+            } else {
+                std::cerr << "Unknown option: " << name << std::endl;
+                std::exit(EXIT_FAILURE);
+            }
+
+            ++i;
+        }
+
+        return options;
+    }
+
+    double ElapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Медиана времени этапа; prepare выполняется перед каждым замером и не учитывается
+    template <typename Prepare, typename Stage>
+    double MeasureMs(int reps, Prepare&& prepare, Stage&& stage) {
+        std::vector<double> samples;
+        samples.reserve(reps);
+
+        for (int rep = 0; rep < reps; ++rep) {
+            prepare();
+            const auto start = Clock::now();
+            stage();
+            samples.push_back(ElapsedMs(start));
+        }
+
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    template <typename Stage>
+    double MeasureMs(int reps, Stage&& stage) {
+        return MeasureMs(reps, [] {}, std::forward<Stage>(stage));
+    }
+
+    void PrintStage(const char* stage, double ms, size_t rows) {
+        std::cout << "  " << std::left << std::setw(34) << stage << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(12) << ms << " ms";
+        if (rows > 0 && ms > 0.0) {
+            std::cout << std::setw(12) << std::setprecision(2) << rows / ms / 1000.0
+                      << " Mrows/s";
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+
+    void RunCreateReport(MockServer&          server,
+                         time_t               from,
+                         time_t               to,
+                         int                  top_count,
+                         rapidjson::Document& response) {
+        rapidjson::Document request;
+        request.SetObject();
+        request.AddMember("group", "*", request.GetAllocator());
+        request.AddMember("from", static_cast<int>(from), request.GetAllocator());
+        request.AddMember("to", static_cast<int>(to), request.GetAllocator());
+        request.AddMember("top_count", top_count, request.GetAllocator());
+
+        response.SetObject();
+        CreateReport(request, response, response.GetAllocator(), &server);
+    }
+
+    void RunCreateReport(MockServer& server, time_t from, time_t to, int top_count) {
+        rapidjson::Document response;
+        RunCreateReport(server, from, to, top_count, response);
+    }
+
+    // Размер и время сериализации готового ответа в JSON (как его пишет хост)
+    void BenchmarkEncoding(const rapidjson::Document& response, int reps) {
+        size_t       json_bytes = 0;
+        const double json_ms    = MeasureMs(reps, [&] {
+            rapidjson::StringBuffer                    buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            response.Accept(writer);
+            json_bytes = buffer.GetSize();
+        });
+        PrintStage("encode JSON (rapidjson::Writer)", json_ms, 0);
+
+        std::cout << "    response bytes: " << json_bytes << std::endl;
+    }
+
+    void BenchmarkStages(MockServer&             server,
+                         const BenchmarkOptions& options,
+                         time_t                  from,
+                         time_t                  to) {
+        const int    reps        = options.reps;
+        const time_t window_from = utils::CalculateTimestampForTwoWeeksAgo(static_cast<int>(from));
+
+        std::vector<TradeRecord> records;
+        const double             fetch_ms = MeasureMs(
+            reps,
+            [&] { std::vector<TradeRecord>().swap(records); },
+            [&] { server.GetCloseTradesByGroup("*", window_from, to, &records); });
+        const size_t rows_count = records.size();
+        PrintStage("server fetch (mock generator)", fetch_ms, rows_count);
+
+        std::vector<TradeRecord> records_copy;
+        TradeColumns             trades;
+        const double             ingest_ms = MeasureMs(
+            reps,
+            [&] {
+                records_copy = records;
+                trades       = TradeColumns();
+            },
+            [&] { trades.Ingest(std::move(records_copy)); });
+        PrintStage("TradeColumns::Ingest", ingest_ms, rows_count);
+        std::vector<TradeRecord>().swap(records);
+
+        std::vector<GroupRecord> groups;
+        server.GetAllGroups(&groups);
+        const GroupIndex group_index(groups);
+
+        const double conversion_ms = MeasureMs(reps, [&] {
+            AccountCache account_cache(&server);
+            RateTable    rate_table(&server, group_index.Currencies());
+            account_cache.Preload(group_index, "*");
+
+            for (size_t i = 0; i < trades.Size(); ++i) {
+                const AccountRecord& account = account_cache.Get(trades.login[i]);
+                const GroupInfo*     group   = group_index.Find(account.group);
+
+                if (group == nullptr) {
+                    continue;
+                }
+
+                const double multiplier = rate_table.Get(group->currency_id, trades.cmd[i]);
+
+                trades.usd_profit[i]   = trades.profit[i] * multiplier;
+                trades.is_converted[i] = 1;
+            }
+        });
+        PrintStage("account preload + USD conversion", conversion_ms, rows_count);
+
+        const utils::DayBucketer day_buckets(window_from, to);
+
+        const double daily_ms = MeasureMs(reps, [&] {
+            std::map<time_t, DailyTradesAggregate> daily;
+            utils::DailyAggregateAccumulator       accumulator(daily, day_buckets);
+            utils::RunAggregation(trades, {&accumulator});
+        });
+        PrintStage("daily aggregation", daily_ms, rows_count);
+
+        const double top_orders_ms = MeasureMs(reps, [&] {
+            utils::TopOrdersAccumulator top_orders(from, options.top_count);
+            utils::RunAggregation(trades, {&top_orders});
+        });
+        PrintStage("top orders selection", top_orders_ms, rows_count);
+
+        std::map<time_t, DailyTradesAggregate> daily_aggregates;
+
+        const double fused_ms = MeasureMs(reps, [&] {
+            daily_aggregates.clear();
+            utils::DailyAggregateAccumulator accumulator(daily_aggregates, day_buckets);
+            utils::TopOrdersAccumulator      top_orders(from, options.top_count);
+            utils::RunAggregation(trades, {&accumulator, &top_orders});
+        });
+        PrintStage("fused closed-trades pass", fused_ms, rows_count);
+
+        // Параллельный проход должен давать тот же результат, что и однопоточный
+        ThreadPool                             pool;
+        std::map<time_t, DailyTradesAggregate> parallel_aggregates;
+        utils::TopOrdersAccumulator            serial_top_orders(from, options.top_count);
+        utils::TopOrdersAccumulator            parallel_top_orders(from, options.top_count);
+
+        const double parallel_ms = MeasureMs(reps, [&] {
+            parallel_aggregates.clear();
+            utils::DailyAggregateAccumulator accumulator(parallel_aggregates, day_buckets);
+            parallel_top_orders = utils::TopOrdersAccumulator(from, options.top_count);
+            utils::RunAggregation(trades, {&accumulator, &parallel_top_orders}, &pool);
+        });
+        const std::string parallel_stage =
+            "fused pass, " + std::to_string(pool.Size() + 1) + " threads";
+        PrintStage(parallel_stage.c_str(), parallel_ms, rows_count);
+
+        utils::RunAggregation(trades, {&serial_top_orders});
+
+        const bool is_parallel_consistent =
+            parallel_aggregates.size() == daily_aggregates.size() &&
+            std::equal(daily_aggregates.begin(),
+                       daily_aggregates.end(),
+                       parallel_aggregates.begin(),
+                       [](const auto& lhs, const auto& rhs) {
+                           return lhs.first == rhs.first &&
+                                  std::memcmp(&lhs.second,
+                                              &rhs.second,
+                                              sizeof(DailyTradesAggregate)) == 0;
+                       }) &&
+            serial_top_orders.TopProfit() == parallel_top_orders.TopProfit() &&
+            serial_top_orders.TopLoss() == parallel_top_orders.TopLoss();
+        std::cout << "    parallel result " << (is_parallel_consistent ? "matches" : "DIFFERS FROM")
+                  << " serial" << std::endl;
+
+        const double open_positions_ms = MeasureMs(reps, [&] {
+            utils::OpenPositionsAccumulator open_positions;
+            utils::RunAggregation(trades, {&open_positions});
+        });
+        PrintStage("open positions pass", open_positions_ms, rows_count);
+
+        volatile double sink      = 0.0;
+        const double    kernel_ms = MeasureMs(reps, [&] {
+            const utils::simd::ProfitLossSums sums = utils::simd::SumProfitLoss(
+                trades.usd_profit.data(), trades.is_converted.data(), trades.Size());
+            sink = sums.profit + sums.loss;
+        });
+        PrintStage("simd::SumProfitLoss kernel", kernel_ms, rows_count);
+
+        const double charts_ms = MeasureMs(reps, [&] {
+            rapidjson::Document                 document;
+            rapidjson::Document::AllocatorType& allocator = document.GetAllocator();
+
+            document.SetArray();
+            document.PushBack(utils::CreatePnlChartData(daily_aggregates, allocator), allocator);
+            document.PushBack(utils::CreateTradesCountChartData(daily_aggregates, allocator),
+                              allocator);
+        });
+        PrintStage("chart data emission", charts_ms, 0);
+    }
+
+    void BenchmarkCreateReport(MockServer&             server,
+                               const BenchmarkOptions& options,
+                               time_t                  from,
+                               time_t                  to) {
+        const int reps = options.reps;
+
+        // Снимок на диске замеряется отдельным этапом: холодный отчет строится без него
+        const char*       snapshot_env  = std::getenv("DAILY_TRADES_SNAPSHOT_PATH");
+        const std::string snapshot_path = snapshot_env != nullptr ? snapshot_env : "";
+        unsetenv("DAILY_TRADES_SNAPSHOT_PATH");
+
+        // Кэш готовых ответов выключен, чтобы замерять построение отчета
+        setenv("DAILY_TRADES_RESULT_CACHE_TTL", "0", 1);
+
+        PrintStage("CreateReport cold (empty caches)",
+                   MeasureMs(
+                       reps,
+                       [] { DestroyReport(); },
+                       [&] { RunCreateReport(server, from, to, options.top_count); }),
+                   server.Config().closed_trades_count);
+
+        DestroyReport();
+        RunCreateReport(server, from, to, options.top_count);
+        server.Calls().Reset();
+
+        PrintStage("CreateReport warm (reference caches)",
+                   MeasureMs(reps, [&] { RunCreateReport(server, from, to, options.top_count); }),
+                   0);
+        std::cout << "    server calls per warm report: " << server.Calls().Total() / reps
+                  << std::endl;
+
+        rapidjson::Document response;
+        RunCreateReport(server, from, to, options.top_count, response);
+        BenchmarkEncoding(response, reps);
+
+        // Выгрузка в файл замеряется, только если задан каталог выгрузки
+        if (std::getenv("DAILY_TRADES_EXPORT_DIR") != nullptr) {
+            rapidjson::Document request;
+            request.SetObject();
+            request.AddMember("group", "*", request.GetAllocator());
+            request.AddMember("from", static_cast<int>(from), request.GetAllocator());
+            request.AddMember("to", static_cast<int>(to), request.GetAllocator());
+
+            uint64_t     export_rows = 0;
+            const double export_ms   = MeasureMs(reps, [&] {
+                rapidjson::Document export_response;
+                ExportReport(request, export_response, export_response.GetAllocator(), &server);
+                if (export_response.HasMember("export")) {
+                    export_rows = export_response["export"]["rows"].GetUint64();
+                    std::remove(export_response["export"]["path"].GetString());
+                }
+            });
+            PrintStage("ExportReport CSV", export_ms, export_rows);
+        }
+
+        // Перезапуск плагина со снимком: DestroyReport пишет снимок, первый отчет
+        // после него берет итоги дней и справочные данные из файла
+        if (!snapshot_path.empty()) {
+            setenv("DAILY_TRADES_SNAPSHOT_PATH", snapshot_path.c_str(), 1);
+            DestroyReport();
+            RunCreateReport(server, from, to, options.top_count);
+
+            PrintStage("CreateReport after restart (snapshot)",
+                       MeasureMs(
+                           reps,
+                           [] { DestroyReport(); },
+                           [&] { RunCreateReport(server, from, to, options.top_count); }),
+                       server.Config().closed_trades_count);
+
+            DestroyReport();
+            unsetenv("DAILY_TRADES_SNAPSHOT_PATH");
+            std::remove(snapshot_path.c_str());
+        }
+
+        setenv("DAILY_TRADES_RESULT_CACHE_TTL", "60", 1);
+        DestroyReport();
+        RunCreateReport(server, from, to, options.top_count);
+
+        PrintStage("CreateReport cached response",
+                   MeasureMs(reps, [&] { RunCreateReport(server, from, to, options.top_count); }),
+                   0);
+
+        DestroyReport();
+
+        // Переменная восстанавливается для этапа со снимком у следующего размера
+        if (!snapshot_path.empty()) {
+            setenv("DAILY_TRADES_SNAPSHOT_PATH", snapshot_path.c_str(), 1);
+        }
+    }
+
+    // Отчет за текущий день из резидентного состояния и стоимость применения события
+    void BenchmarkIncrementalState(MockServer&             server,
+                                   const BenchmarkOptions& options,
+                                   time_t                  from,
+                                   time_t                  to) {
+        constexpr size_t EVENTS_COUNT = 100000;
+
+        const int reps = options.reps;
+
+        setenv("DAILY_TRADES_RESULT_CACHE_TTL", "0", 1);
+        setenv("DAILY_TRADES_INCREMENTAL_STATE", "1", 1);
+
+        // Первый отчет - пакетный расчет, заполняющий состояние групп
+        DestroyReport();
+        PrintStage("CreateReport seeding state",
+                   MeasureMs(1, [&] { RunCreateReport(server, from, to, options.top_count); }),
+                   server.Config().closed_trades_count);
+
+        server.Calls().Reset();
+        PrintStage("CreateReport from state",
+                   MeasureMs(reps, [&] { RunCreateReport(server, from, to, options.top_count); }),
+                   0);
+        std::cout << "    server calls per state report: " << server.Calls().Total() / reps
+                  << std::endl;
+
+        // Закрытия новых сделок текущего дня (сервер мока о них не знает)
+        const time_t now         = std::time(nullptr);
+        const size_t first_order = server.Config().closed_trades_count;
+
+        const double events_ms = MeasureMs(1, [&] {
+            for (size_t i = 0; i < EVENTS_COUNT; ++i) {
+                TradeRecord trade = server.MakeTrade(first_order + i, false);
+                trade.close_time  = now;
+                trade.open_time   = now - 60;
+                OnTradeEvent(EV_RECORD_CLOSE_TRADE, trade, &server);
+            }
+        });
+        PrintStage("OnTradeEvent close", events_ms, EVENTS_COUNT);
+
+        unsetenv("DAILY_TRADES_INCREMENTAL_STATE");
+        setenv("DAILY_TRADES_RESULT_CACHE_TTL", "60", 1);
+        DestroyReport();
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options = ParseOptions(argc, argv);
+
+    const utils::simd::KernelVariant variant               = utils::simd::ActiveVariant();
+    const bool                       is_kernels_consistent = utils::simd::CrossCheckKernels();
+
+    std::cout << "SIMD kernels: " << utils::simd::VariantName(variant)
+              << ", cross-check " << (is_kernels_consistent ? "passed" : "FAILED") << std::endl;
+
+    // Отчет за последний завершенный день
+    const time_t to   = utils::CalculateDayStart(std::time(nullptr)) - 1;
+    const time_t from = utils::CalculateDayStart(to);
+
+    for (const size_t size : options.sizes) {
+        options.synthetic.closed_trades_count = size;
+        options.synthetic.to                  = to;
+
+        MockServer server(options.synthetic);
+        server.SetVerbose(options.is_verbose);
+
+        std::cout << "\n== " << size << " closed trades, " << options.synthetic.accounts_count
+                  << " accounts, " << options.synthetic.groups_count << " groups, skew "
+                  << options.synthetic.login_skew << ", latency "
+                  << options.synthetic.call_latency.count() << " us, median of " << options.reps
+                  << " ==" << std::endl;
+
+        BenchmarkStages(server, options, from, to);
+        BenchmarkCreateReport(server, options, from, to);
+        BenchmarkIncrementalState(
+            server, options, to + 1, utils::CalculateNextDayStart(to + 1) - 1);
+    }
+
+    return is_kernels_consistent ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,221 @@
+#include "MockServer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#include "utils/Utils.h"
+
+namespace {
+    // Номер открытой позиции не пересекается с номерами закрытых сделок
+    constexpr int OPEN_ORDER_OFFSET = 1000000000;
+
+    // splitmix64: независимая псевдослучайная последовательность для каждой сделки
+    uint64_t Mix(uint64_t value) {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    double ToUnit(uint64_t random) { return static_cast<double>(random >> 11) * 0x1.0p-53; }
+} // namespace
+
+void MockServerCalls::Reset() {
+    get_accounts_by_group     = 0;
+    get_account_by_login      = 0;
+    get_close_trades_by_group = 0;
+    get_open_trades_by_group  = 0;
+    get_all_groups            = 0;
+    calculate_convert_rate    = 0;
+}
+
+uint64_t MockServerCalls::Total() const {
+    return get_accounts_by_group + get_account_by_login + get_close_trades_by_group +
+           get_open_trades_by_group + get_all_groups + calculate_convert_rate;
+}
+
+MockServer::MockServer(const SyntheticConfig& config)
+    : _config(config), _window_from(config.to - static_cast<time_t>(config.days) * 86400 + 1) {
+    _groups.reserve(_config.groups_count);
+    for (int i = 0; i < _config.groups_count; ++i) {
+        GroupRecord group;
+        group.group    = "real\\group_" + std::to_string(i);
+        group.currency = _config.currencies[i % _config.currencies.size()];
+        _groups.push_back(std::move(group));
+    }
+
+    _accounts.reserve(_config.accounts_count);
+    for (int login = 1; login <= _config.accounts_count; ++login) {
+        AccountRecord account;
+        account.login = login;
+        account.group = _groups[(login - 1) % _groups.size()].group;
+        account.name  = "Client " + std::to_string(login);
+        _accounts.push_back(std::move(account));
+    }
+}
+
+int MockServer::LogsOut(const std::string& type, const std::string& message) {
+    if (_is_verbose) {
+        std::cerr << "[" << type << "] " << message << std::endl;
+    }
+    return RET_OK;
+}
+
+int MockServer::GetAccountsByGroup(const std::string& group, std::vector<AccountRecord>* accounts) {
+    ++_calls.get_accounts_by_group;
+    SimulateLatency();
+
+    for (const AccountRecord& account : _accounts) {
+        if (account.group == group) {
+            accounts->push_back(account);
+        }
+    }
+    return RET_OK;
+}
+
+int MockServer::GetAccountByLogin(int login, AccountRecord* account) {
+    ++_calls.get_account_by_login;
+    SimulateLatency();
+
+    if (login < 1 || login > static_cast<int>(_accounts.size())) {
+        return RET_ERROR;
+    }
+
+    *account = _accounts[login - 1];
+    return RET_OK;
+}
+
+int MockServer::GetCloseTradesByGroup(const std::string&        filter_group,
+                                      time_t                    from,
+                                      time_t                    to,
+                                      std::vector<TradeRecord>* trades) {
+    ++_calls.get_close_trades_by_group;
+    SimulateLatency();
+
+    // Время закрытия монотонно растет с номером сделки - диапазон находится двоичным поиском
+    const size_t count      = _config.closed_trades_count;
+    const auto   close_time = [this, count](size_t index) {
+        const auto span = static_cast<__int128>(_config.to - _window_from);
+        return _window_from + static_cast<time_t>(span * index / std::max<size_t>(count, 1));
+    };
+    const auto lower_bound = [&close_time, count](time_t time) {
+        size_t low = 0, high = count;
+        while (low < high) {
+            const size_t middle = (low + high) / 2;
+            if (close_time(middle) < time) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    };
+
+    const size_t begin = lower_bound(from);
+    const size_t end   = lower_bound(to + 1);
+
+    trades->reserve(trades->size() + (end - begin));
+    for (size_t i = begin; i < end; ++i) {
+        TradeRecord trade = MakeTrade(i, false);
+        trade.close_time  = close_time(i);
+        trade.open_time   = trade.close_time - 60 - static_cast<time_t>(Mix(i) % 86400);
+
+        if (IsLoginInGroups(filter_group, trade.login)) {
+            trades->push_back(std::move(trade));
+        }
+    }
+    return RET_OK;
+}
+
+int MockServer::GetOpenTradesByGroup(const std::string&        filter_group,
+                                     time_t                    /*from*/,
+                                     time_t                    /*to*/,
+                                     std::vector<TradeRecord>* trades) {
+    ++_calls.get_open_trades_by_group;
+    SimulateLatency();
+
+    const auto count =
+        static_cast<size_t>(static_cast<double>(_config.closed_trades_count) *
+                            _config.open_trades_ratio);
+
+    for (size_t i = 0; i < count; ++i) {
+        TradeRecord trade = MakeTrade(i, true);
+
+        if (IsLoginInGroups(filter_group, trade.login)) {
+            trades->push_back(std::move(trade));
+        }
+    }
+    return RET_OK;
+}
+
+int MockServer::GetAllGroups(std::vector<GroupRecord>* groups) {
+    ++_calls.get_all_groups;
+    SimulateLatency();
+
+    *groups = _groups;
+    return RET_OK;
+}
+
+int MockServer::CalculateConvertRateByCurrency(const std::string& from_cur,
+                                               const std::string& /*to_cur*/,
+                                               int                cmd,
+                                               double*            multiplier) {
+    ++_calls.calculate_convert_rate;
+    SimulateLatency();
+
+    double rate = 1.0;
+    if (from_cur == "EUR") {
+        rate = 1.08;
+    } else if (from_cur == "GBP") {
+        rate = 1.27;
+    } else if (from_cur == "JPY") {
+        rate = 0.0067;
+    }
+
+    // Спред между покупкой и продажей
+    *multiplier = cmd == OP_BUY ? rate : rate * 0.9995;
+    return RET_OK;
+}
+
+TradeRecord MockServer::MakeTrade(size_t index, bool is_open) const {
+    const uint64_t random = Mix(_config.seed ^ (index * 2 + (is_open ? 1 : 0)));
+    const uint64_t extra  = Mix(random);
+
+    TradeRecord trade;
+    trade.order       = static_cast<int>(index + 1) + (is_open ? OPEN_ORDER_OFFSET : 0);
+    trade.login       = MakeLogin(random);
+    trade.symbol      = _symbols[extra % _symbols.size()];
+    trade.cmd         = static_cast<int>((extra >> 8) & 1);
+    trade.volume      = 1 + static_cast<int>((extra >> 16) % 1000);
+    trade.open_price  = 1.0 + static_cast<double>((extra >> 32) % 10000) / 10000.0;
+    trade.close_price =
+        trade.open_price + (static_cast<double>((extra >> 40) % 201) - 100.0) / 10000.0;
+    trade.profit      = (static_cast<double>((random >> 24) % 200001) - 100000.0) / 100.0;
+    trade.storage     = (static_cast<double>((random >> 48) % 2001) - 1000.0) / 100.0;
+    trade.close_time  = 0;
+    trade.open_time   = is_open ? _window_from + static_cast<time_t>(extra % (_config.days * 86400))
+                                : 0;
+    return trade;
+}
+
+int MockServer::MakeLogin(uint64_t random) const {
+    const double position = std::pow(ToUnit(random), _config.login_skew);
+    const int    login    = 1 + static_cast<int>(position * _config.accounts_count);
+    return std::min(login, _config.accounts_count);
+}
+
+bool MockServer::IsLoginInGroups(const std::string& filter_group, int login) const {
+    if (filter_group == "*") {
+        return true;
+    }
+
+    return utils::MatchGroupMask(filter_group, _accounts[login - 1].group);
+}
+
+void MockServer::SimulateLatency() const {
+    if (_config.call_latency.count() > 0) {
+        std::this_thread::sleep_for(_config.call_latency);
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "Structures.h"
+
+// Параметры синтетических данных сервера
+struct SyntheticConfig {
+    int                      groups_count   = 20;
+    int                      accounts_count = 10000;
+    std::vector<std::string> currencies{"USD", "EUR", "GBP", "JPY"};
+
+    // Закрытые сделки равномерно распределены по дням окна [to - days, to]
+    size_t closed_trades_count = 10000;
+    int    days                = 15;
+
+    // Доля открытых позиций относительно закрытых сделок
+    double open_trades_ratio = 0.1;
+
+    // Перекос логинов: 1.0 - равномерно, больше - сделки концентрируются у малых логинов
+    double login_skew = 2.0;
+
+    // Задержка каждого вызова сервера, имитирующая сеть / блокировки
+    std::chrono::microseconds call_latency{0};
+
+    time_t   to   = 0;
+    uint64_t seed = 42;
+};
+
+// Счетчики вызовов методов сервера
+struct MockServerCalls {
+    std::atomic<uint64_t> get_accounts_by_group{0};
+    std::atomic<uint64_t> get_account_by_login{0};
+    std::atomic<uint64_t> get_close_trades_by_group{0};
+    std::atomic<uint64_t> get_open_trades_by_group{0};
+    std::atomic<uint64_t> get_all_groups{0};
+    std::atomic<uint64_t> calculate_convert_rate{0};
+
+    void Reset();
+
+    [[nodiscard]] uint64_t Total() const;
+};
+
+// Сервер в памяти: сделки генерируются детерминированно по номеру сделки
+// при каждом запросе и не хранятся, поэтому память мока не растет с объемом
+class MockServer final : public CServerInterface {
+public:
+    explicit MockServer(const SyntheticConfig& config);
+
+    int LogsOut(const std::string& type, const std::string& message) override;
+
+    int GetAccountsByGroup(const std::string& group, std::vector<AccountRecord>* accounts) override;
+
+    int GetAccountByLogin(int login, AccountRecord* account) override;
+
+    int GetCloseTradesByGroup(const std::string&        filter_group,
+                              time_t                    from,
+                              time_t                    to,
+                              std::vector<TradeRecord>* trades) override;
+
+    int GetOpenTradesByGroup(const std::string&        filter_group,
+                             time_t                    from,
+                             time_t                    to,
+                             std::vector<TradeRecord>* trades) override;
+
+    int GetAllGroups(std::vector<GroupRecord>* groups) override;
+
+    int CalculateConvertRateByCurrency(const std::string& from_cur,
+                                       const std::string& to_cur,
+                                       int                cmd,
+                                       double*            multiplier) override;
+
+    [[nodiscard]] const SyntheticConfig& Config() const { return _config; }
+
+    MockServerCalls& Calls() { return _calls; }
+
+    void SetVerbose(bool is_verbose) { _is_verbose = is_verbose; }
+
+    // Сделка с номером index (закрытая или открытая)
+    [[nodiscard]] TradeRecord MakeTrade(size_t index, bool is_open) const;
+
+private:
+    [[nodiscard]] int  MakeLogin(uint64_t random) const;
+    [[nodiscard]] bool IsLoginInGroups(const std::string& filter_group, int login) const;
+    void               SimulateLatency() const;
+
+    SyntheticConfig            _config;
+    std::vector<GroupRecord>   _groups;
+    std::vector<AccountRecord> _accounts;
+    std::vector<std::string>   _symbols{"EURUSD", "GBPUSD", "USDJPY", "XAUUSD", "BTCUSD", "US500"};
+    time_t                     _window_from;
+    MockServerCalls            _calls;
+    bool                       _is_verbose = false;
+};
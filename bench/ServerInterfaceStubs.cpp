@@ -0,0 +1,221 @@
+// Определения методов CServerInterface для сборки бенчмарка вне сервера:
+// в плагине они предоставляются сервером. Мок переопределяет только нужные методы
+#include "Structures.h"
+
+int CServerInterface::TickSet(TickInfo&) {
+    return RET_OK;
+}
+
+int CServerInterface::LogsOut(const std::string&, const std::string&) {
+    return RET_OK;
+}
+
+int CServerInterface::GetLogs(time_t,
+                              time_t,
+                              const std::string&,
+                              const std::string&,
+                              std::vector<ServerLog>*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetAccountsByGroup(const std::string&, std::vector<AccountRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetAccountByLogin(int, AccountRecord*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetAccountBalanceByLogin(int, MarginLevel*) {
+    return RET_OK;
+}
+
+int CServerInterface::AddAccount(const AccountRecord&) {
+    return RET_OK;
+}
+
+int CServerInterface::UpdateAccount(const AccountRecord&) {
+    return RET_OK;
+}
+
+int CServerInterface::DeleteAccount(int) {
+    return RET_OK;
+}
+
+int CServerInterface::GetMarginLevelByGroup(const std::string&, std::vector<MarginLevel>*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetAccountsEquitiesByGroup(time_t,
+                                                 time_t,
+                                                 const std::string&,
+                                                 std::vector<EquityRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetAccountsEquitiesByLogin(time_t, time_t, int, std::vector<EquityRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::OpenTrade(const TradeRecord&) {
+    return RET_OK;
+}
+
+int CServerInterface::CloseTrade(const TradeRecord&) {
+    return RET_OK;
+}
+
+int CServerInterface::UpdateOpenTrade(const TradeRecord&) {
+    return RET_OK;
+}
+
+int CServerInterface::UpdateCloseTrade(const TradeRecord&) {
+    return RET_OK;
+}
+
+int CServerInterface::CheckOpenTrade(const TradeRecord&) {
+    return RET_OK;
+}
+
+int CServerInterface::CheckCloseTrade(const TradeRecord&) {
+    return RET_OK;
+}
+
+int CServerInterface::GetOpenTradesByLogin(int, std::vector<TradeRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetOpenTradesByMagic(int, std::vector<TradeRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetOpenTradeByOrder(int, TradeRecord*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetOpenTradesByGroup(const std::string&,
+                                           time_t,
+                                           time_t,
+                                           std::vector<TradeRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetCloseTradesByLogin(int, std::vector<TradeRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetCloseTradesByGroup(const std::string&,
+                                            time_t,
+                                            time_t,
+                                            std::vector<TradeRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetPendingTradesByGroup(const std::string&,
+                                              time_t,
+                                              time_t,
+                                              std::vector<TradeRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetAllOpenTrades(std::vector<TradeRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::BalanceIn(int, double, const std::string&) {
+    return RET_OK;
+}
+
+int CServerInterface::BalanceOut(int, double, const std::string&) {
+    return RET_OK;
+}
+
+int CServerInterface::CreditIn(int, double, const std::string&) {
+    return RET_OK;
+}
+
+int CServerInterface::CreditOut(int, double, const std::string&) {
+    return RET_OK;
+}
+
+int CServerInterface::GetTransactionsByGroup(const std::string&,
+                                             time_t,
+                                             time_t,
+                                             std::vector<TradeRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetSymbol(const std::string&, SymbolRecord*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetGroup(const std::string&, GroupRecord*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetAllGroups(std::vector<GroupRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::CalculateCommission(const TradeRecord&, double*) {
+    return RET_OK;
+}
+
+int CServerInterface::CalculateSwap(const TradeRecord&, double*) {
+    return RET_OK;
+}
+
+int CServerInterface::CalculateProfit(const TradeRecord&, double*) {
+    return RET_OK;
+}
+
+int CServerInterface::CalculateMargin(const TradeRecord&, double*) {
+    return RET_OK;
+}
+
+int CServerInterface::CalculateConvertRateByCurrency(const std::string&,
+                                                     const std::string&,
+                                                     int,
+                                                     double*) {
+    return RET_OK;
+}
+
+int CServerInterface::GetCandles(const std::string&,
+                                 const std::string&,
+                                 time_t,
+                                 time_t,
+                                 std::vector<CandleRecord>*) {
+    return RET_OK;
+}
+
+int CServerInterface::SetCandles(const std::string&, const std::vector<CandleRecord>&) {
+    return RET_OK;
+}
+
+int CServerInterface::DeleteCandlesAll(const std::string&) {
+    return RET_OK;
+}
+
+int CServerInterface::DeleteCandlesPeriod(const std::string&, time_t, time_t) {
+    return RET_OK;
+}
+
+int CServerInterface::SendToManager(int, const Value&) {
+    return RET_OK;
+}
+
+int CServerInterface::BroadcastToManagers(const Value&) {
+    return RET_OK;
+}
+
+int CServerInterface::SendToAccount(int, const Value&) {
+    return RET_OK;
+}
+
+int CServerInterface::BroadcastToAccounts(const Value&) {
+    return RET_OK;
+}
+
+int CServerInterface::SendState(const Value&) {
+    return RET_OK;
+}
@@ -1,6 +1,14 @@
 #pragma once
 
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 #include <optional>
@@ -61,6 +69,10 @@ struct FilterConfig {
     // Список опций для select-фильтра
     std::vector<FilterOption> options;
 
+    // Имя общего словаря опций ответа - вместо собственного списка options,
+    // когда один и тот же список нужен нескольким колонкам
+    std::optional<std::string> options_ref;
+
     // Ключ значения для поиска в объекте опции
     std::optional<std::string> search_option_key;
 
@@ -84,14 +96,31 @@ struct TableColumn {
     bool is_sorted = true;              // Доступна ли сортировка (может отсутствовать)
 };
 
-// Основной класс для пошаговой сборки JSON-описания таблицы
+// Тип значений колонки в хранилище строк таблицы
+enum class ColumnType {
+    Auto,                // Определяется первым значением колонки, числа хранятся как переданы
+    Int64,               // Целое число
+    Double,              // Дробное число с фиксированным количеством знаков (усечение)
+    String,              // Строка, интернируется в словаре таблицы
+    Bool                 // Логическое значение
+};
+
+// Основной класс для пошаговой сборки JSON-описания таблицы.
+// Строки хранятся по колонкам в типизированном виде; ячейки добавляются
+// слева направо в порядке AddColumn, новая строка начинается автоматически.
+// Число в строковой колонке записывается текстом, строка в числовой - ошибка
+
 class TableBuilder {
 public:
     explicit TableBuilder(const std::string& table_name)
         : _table_name(table_name) {}
 
-    void AddColumn(const TableColumn& column) {
+    void AddColumn(const TableColumn& column,
+                   const ColumnType   type   = ColumnType::Auto,
+                   const int          digits = 0) {
         _column_order_by_keys.push_back(column.key);
+        _columns.push_back({type, type == ColumnType::Double ? std::pow(10.0, digits) : 0.0, {}, {}, {}});
+        Reserve(_columns.back());
 
         JSONObject column_obj;
         column_obj["name"] = column.language_token;
@@ -106,15 +135,80 @@ public:
         _structure[column.key] = std::move(column_obj);
     }
 
-    void AddRow(const std::vector<JSONValue>& row_values) {
-        JSONArray json_row;
-        json_row.reserve(row_values.size());
+    // Резерв памяти под ожидаемое количество строк
+    void ReserveRows(const size_t rows_count) {
+        _reserved_rows = rows_count;
+        for (auto& column : _columns) {
+            Reserve(column);
+        }
+    }
+
+    void AddInt(const int64_t value) {
+        Column& column = NextCell(ColumnType::Int64);
+
+        switch (column.type) {
+            case ColumnType::Auto:
+            case ColumnType::Int64: column.ints.push_back(value); break;
+            case ColumnType::Double: column.doubles.push_back(static_cast<double>(value)); break;
+            case ColumnType::String: column.string_ids.push_back(Intern(std::to_string(value))); break;
+            case ColumnType::Bool: column.ints.push_back(value != 0); break;
+        }
+    }
+
+    void AddDouble(const double value) {
+        Column& column = NextCell(ColumnType::Double);
+
+        switch (column.type) {
+            case ColumnType::Auto:
+            case ColumnType::Double: column.doubles.push_back(value); break;
+            case ColumnType::Int64: column.ints.push_back(static_cast<int64_t>(value)); break;
+            case ColumnType::String: column.string_ids.push_back(Intern(FormatDouble(value))); break;
+            case ColumnType::Bool: column.ints.push_back(value != 0.0); break;
+        }
+    }
+
+    void AddBool(const bool value) {
+        Column& column = NextCell(ColumnType::Bool);
+
+        switch (column.type) {
+            case ColumnType::Auto:
+            case ColumnType::Bool:
+            case ColumnType::Int64: column.ints.push_back(value ? 1 : 0); break;
+            case ColumnType::Double: column.doubles.push_back(value ? 1.0 : 0.0); break;
+            case ColumnType::String: column.string_ids.push_back(Intern(value ? "true" : "false")); break;
+        }
+    }
+
+    void AddString(const std::string_view value) {
+        Column& column = NextCell(ColumnType::String);
 
+        if (column.type != ColumnType::String) {
+            throw std::invalid_argument("TableBuilder: string in numeric column");
+        }
+
+        column.string_ids.push_back(Intern(value));
+    }
+
+    // Совместимость с построчным API: значения раскладываются по типизированным колонкам,
+    // колонки без явного типа получают тип первого значения
+    void AddRow(const JSONArray& row_values) {
         for (const auto& val : row_values) {
-            json_row.push_back(val);
+            std::visit([this](auto&& arg) {
+                using T = std::decay_t<decltype(arg)>;
+                if constexpr (std::is_same_v<T, std::string>)
+                    AddString(arg);
+                else if constexpr (std::is_same_v<T, double>)
+                    AddDouble(arg);
+                else if constexpr (std::is_same_v<T, bool>)
+                    AddBool(arg);
+                else
+                    throw std::invalid_argument("TableBuilder: nested value in table cell");
+            }, val.value);
         }
+    }
 
-        _rows.push_back(std::move(json_row));
+    [[nodiscard]] size_t RowsCount() const {
+        return _columns.empty() ? 0 : _cells_count / _columns.size();
     }
 
     void SetIdColumn(const std::string& id_column) { _id_column = id_column; }
@@ -155,10 +249,23 @@ public:
 
         JSONObject data_obj;
         JSONArray json_rows;
-        json_rows.reserve(_rows.size());
+        json_rows.reserve(RowsCount());
+
+        for (size_t row = 0; row < RowsCount(); ++row) {
+            JSONArray json_row;
+            json_row.reserve(_columns.size());
+
+            for (const auto& column : _columns) {
+                switch (column.type) {
+                    case ColumnType::Auto: break;
+                    case ColumnType::Int64: json_row.emplace_back(static_cast<double>(column.ints[row])); break;
+                    case ColumnType::Double: json_row.emplace_back(Truncate(column, row)); break;
+                    case ColumnType::String: json_row.emplace_back(_strings[column.string_ids[row]]); break;
+                    case ColumnType::Bool: json_row.emplace_back(column.ints[row] != 0); break;
+                }
+            }
 
-        for (const auto& row : _rows) {
-            json_rows.emplace_back(row);
+            json_rows.emplace_back(std::move(json_row));
         }
 
         data_obj["rows"] = std::move(json_rows);
@@ -178,11 +285,128 @@ public:
         return table_props;
     }
 
+    // Запись props таблицы сразу в rapidjson-значение ответа, минуя копию в JSONObject.
+    // Каждая уникальная строка копируется в аллокатор один раз, ячейки ссылаются на нее;
+    // хранилище колонок освобождается после записи
+    void Finalize(Value& table_props, Document::AllocatorType& allocator) && {
+        table_props.SetObject();
+        table_props.AddMember("name", Value(_table_name.c_str(), allocator), allocator);
+        table_props.AddMember("idCol", Value(_id_column.c_str(), allocator), allocator);
+
+        Value order_by(kArrayType);
+        order_by.PushBack(Value(_order_by.first.c_str(), allocator), allocator);
+        order_by.PushBack(Value(_order_by.second.c_str(), allocator), allocator);
+        table_props.AddMember("orderBy", order_by, allocator);
+
+        table_props.AddMember("autoSave", _is_auto_save_enabled, allocator);
+        table_props.AddMember("showRefreshBtn", _is_refresh_button_enabled, allocator);
+        table_props.AddMember("showBookmarksBtn", _is_bookmarks_button_enabled, allocator);
+        table_props.AddMember("showExportBtn", _is_export_button_enabled, allocator);
+        table_props.AddMember("showTotal", _is_total_row_enabled, allocator);
+        table_props.AddMember("totalDataTitle", Value(_total_data_title.c_str(), allocator), allocator);
+
+        if (!_total_data.empty()) {
+            Value total_data(kArrayType);
+            for (const auto& item : _total_data) {
+                Value json_item;
+                to_json_value(item, json_item, allocator);
+                total_data.PushBack(json_item, allocator);
+            }
+            table_props.AddMember("totalData", total_data, allocator);
+        }
+
+        // Словарь строк таблицы в памяти ответа
+        std::vector<const char*> string_refs;
+        string_refs.reserve(_strings.size());
+
+        for (const auto& str : _strings) {
+            char* copy = static_cast<char*>(allocator.Malloc(str.size() + 1));
+            std::memcpy(copy, str.c_str(), str.size() + 1);
+            string_refs.push_back(copy);
+        }
+
+        const size_t rows_count = RowsCount();
+
+        Value rows(kArrayType);
+        rows.Reserve(static_cast<rapidjson::SizeType>(rows_count), allocator);
+
+        for (size_t row = 0; row < rows_count; ++row) {
+            Value json_row(kArrayType);
+            json_row.Reserve(static_cast<rapidjson::SizeType>(_columns.size()), allocator);
+
+            for (const auto& column : _columns) {
+                switch (column.type) {
+                    case ColumnType::Auto:
+                        break;
+                    case ColumnType::Int64:
+                        // Как и в CreateTableProps - числом с точкой (325.0), в формате ast
+                        json_row.PushBack(Value(static_cast<double>(column.ints[row])), allocator);
+                        break;
+                    case ColumnType::Bool:
+                        json_row.PushBack(Value(column.ints[row] != 0), allocator);
+                        break;
+                    case ColumnType::Double:
+                        json_row.PushBack(Value(Truncate(column, row)), allocator);
+                        break;
+                    case ColumnType::String: {
+                        const uint32_t id = column.string_ids[row];
+                        json_row.PushBack(
+                            Value(StringRef(string_refs[id], static_cast<rapidjson::SizeType>(_strings[id].size()))),
+                            allocator);
+                        break;
+                    }
+                }
+            }
+
+            rows.PushBack(json_row, allocator);
+        }
+
+        _columns.clear();
+        _columns.shrink_to_fit();
+        _cells_count = 0;
+
+        Value structure_keys(kArrayType);
+        structure_keys.Reserve(static_cast<rapidjson::SizeType>(_column_order_by_keys.size()), allocator);
+
+        for (const auto& key : _column_order_by_keys) {
+            structure_keys.PushBack(Value(key.c_str(), allocator), allocator);
+        }
+
+        Value data_obj(kObjectType);
+        data_obj.AddMember("rows", rows, allocator);
+        data_obj.AddMember("structure", structure_keys, allocator);
+        table_props.AddMember("data", data_obj, allocator);
+
+        Value structure(kObjectType);
+
+        for (const auto& [key, column] : _structure) {
+            Value column_value;
+            to_json_value(column, column_value, allocator);
+            structure.AddMember(Value(key.c_str(), allocator), column_value, allocator);
+        }
+
+        table_props.AddMember("structure", structure, allocator);
+    }
+
 private:
     std::string _table_name;
     std::string _id_column;
     std::vector<std::string> _column_order_by_keys;
-    std::vector<JSONArray> _rows;
+
+    // Значения одной колонки; заполнен только вектор, соответствующий type
+    struct Column {
+        ColumnType type;
+        double factor;
+        std::vector<int64_t> ints;
+        std::vector<double> doubles;
+        std::vector<uint32_t> string_ids;
+    };
+
+    std::vector<Column> _columns;
+    size_t _cells_count = 0;
+    size_t _reserved_rows = 0;
+    std::deque<std::string> _strings;
+    std::unordered_map<std::string_view, uint32_t> _string_ids;
     JSONObject _structure;
     std::pair<std::string, std::string> _order_by{"id", "DESC"};
     bool _is_auto_save_enabled = false;
@@ -193,6 +417,58 @@ private:
     std::string _total_data_title;
     JSONArray _total_data;
 
+    // Ячейка следующей колонки; колонка без явного типа получает тип значения
+    Column& NextCell(const ColumnType value_type) {
+        if (_columns.empty()) {
+            throw std::logic_error("TableBuilder: no columns");
+        }
+
+        Column& column = _columns[_cells_count++ % _columns.size()];
+        if (column.type == ColumnType::Auto) {
+            column.type = value_type;
+            Reserve(column);
+        }
+
+        return column;
+    }
+
+    void Reserve(Column& column) const {
+        switch (column.type) {
+            case ColumnType::Auto: break;
+            case ColumnType::Int64:
+            case ColumnType::Bool: column.ints.reserve(_reserved_rows); break;
+            case ColumnType::Double: column.doubles.reserve(_reserved_rows); break;
+            case ColumnType::String: column.string_ids.reserve(_reserved_rows); break;
+        }
+    }
+
+    // Кратчайшая запись числа, которая читается обратно без потерь
+    static std::string FormatDouble(const double value) {
+        char buffer[32];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        return std::string(buffer, result.ptr);
+    }
+
+    uint32_t Intern(const std::string_view value) {
+        const auto it = _string_ids.find(value);
+        if (it != _string_ids.end()) {
+            return it->second;
+        }
+
+        const auto id = static_cast<uint32_t>(_strings.size());
+        _strings.emplace_back(value);
+        _string_ids.emplace(_strings.back(), id);
+        return id;
+    }
+
+    // Числа колонки без количества знаков записываются как переданы
+    static double Truncate(const Column& column, const size_t row) {
+        if (column.factor == 0.0) {
+            return column.doubles[row];
+        }
+        return std::trunc(column.doubles[row] * column.factor) / column.factor;
+    }
+
     static JSONObject ConvertFilterToJson(const FilterConfig& filter_config) {
         JSONObject json_object;
         json_object["type"] = ConvertFilterTypeToString(filter_config.type);
@@ -216,6 +492,8 @@ private:
             json_object["options"] = std::move(options_array);
         }
 
+        if (filter_config.options_ref) json_object["options_ref"] = *filter_config.options_ref;
+
         if (filter_config.search_option_key) json_object["search_option_key"] = *filter_config.search_option_key;
         if (filter_config.is_virtualized_options) json_object["is_virtualized_options"] = *filter_config.is_virtualized_options;
         if (filter_config.virtualized_options_height) json_object["virtualized_options_height"] = *filter_config.virtualized_options_height;
@@ -9,7 +9,22 @@
 #include <rapidjson/document.h>
 #include "ast/Ast.hpp"
 #include "sbxTableBuilder/SBXTableBuilder.hpp"
+#include "utils/Aggregation.h"
+#include "utils/DelimitedWriter.h"
+#include "utils/NodeBuilder.h"
+#include "utils/ReportLayout.h"
+#include "utils/ReportMetrics.h"
 #include "utils/Utils.h"
+#include "services/AccountCache.h"
+#include "services/DayAggregateStore.h"
+#include "services/DealsSnapshot.h"
+#include "services/GroupIndex.h"
+#include "services/IncrementalReportState.h"
+#include "services/PluginSnapshot.h"
+#include "services/RateTable.h"
+#include "services/ReferenceCache.h"
+#include "services/ReportResultCache.h"
+#include "services/ThreadPool.h"
 #include "structures/PluginStructures.h"
 
 using namespace ast;
@@ -26,4 +41,22 @@ extern "C" {
                      rapidjson::Value& response,
                      rapidjson::Document::AllocatorType& allocator,
                      CServerInterface* server);
-}
\ No newline at end of file
+
+    // Страница таблицы всех сделок из снимка, сохраненного при построении отчета
+    void GetReportPage(rapidjson::Value& request,
+                       rapidjson::Value& response,
+                       rapidjson::Document::AllocatorType& allocator,
+                       CServerInterface* server);
+
+    // Выгрузка всех сделок выбранных групп за день в CSV/TSV в DAILY_TRADES_EXPORT_DIR
+    void ExportReport(rapidjson::Value& request,
+                      rapidjson::Value& response,
+                      rapidjson::Document::AllocatorType& allocator,
+                      CServerInterface* server);
+
+    // Событие сделки сервера: обновляет резидентное состояние отчета
+    // (DAILY_TRADES_INCREMENTAL_STATE) и помечает устаревшими кэшированные отчеты
+    void OnTradeEvent(EventRecordType record_type,
+                      const TradeRecord& trade,
+                      CServerInterface* server);
+}
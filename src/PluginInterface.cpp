@@ -1,7 +1,327 @@
 #include "PluginInterface.h"
 
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
 
+namespace {
+    // Каркас ответа строится при загрузке плагина, а не первым отчетом
+    const utils::ReportLayout& report_layout = utils::ReportLayout::Instance();
+
+    // Ключ единственной записи индекса групп в кэше плагина
+    constexpr int ALL_GROUPS_KEY = 0;
+
+    // Размер страницы таблицы всех сделок
+    constexpr int DEFAULT_DEALS_PAGE_SIZE = 100;
+    constexpr int MAX_DEALS_PAGE_SIZE     = 1000;
+
+    using DealsSnapshotCache = TtlCache<std::string, DealsSnapshot>;
+
+    // Начиная с этого количества опций список фильтра групп рендерится виртуализированным
+    constexpr size_t VIRTUALIZED_OPTIONS_THRESHOLD = 100;
+
+    std::mutex                         plugin_mutex;
+    std::shared_ptr<ThreadPool>        executor;
+    std::shared_ptr<ReferenceCache>    reference_cache;
+    std::shared_ptr<DayAggregateStore> day_aggregate_store;
+    std::shared_ptr<ReportResultCache> report_result_cache;
+    std::shared_ptr<DealsSnapshotCache> deals_snapshots;
+    std::shared_ptr<IncrementalReportState> incremental_state;
+
+    // Снимок на диске: настройки читаются при создании хранилищ, поколение увеличивается
+    // при выгрузке, чтобы отложенная запись не перезаписала итоговый снимок очищенными данными.
+    // Пока запись стоит в очереди, новые не ставятся - она прочитает хранилища при запуске
+    PluginSnapshotConfig  snapshot_config;
+    time_t                snapshot_written_at = 0;
+    std::atomic<uint64_t> snapshot_generation{0};
+    std::atomic<bool>     is_snapshot_write_queued{false};
+    std::mutex            snapshot_mutex;
+
+    // Поколение сверяется под snapshot_mutex: запись, ожидавшая итоговый снимок выгрузки,
+    // после него пропускается
+    void WriteSnapshot(const std::string&       path,
+                       const DayAggregateStore& aggregate_store,
+                       uint64_t                 generation) {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        if (generation != snapshot_generation.load()) {
+            return;
+        }
+
+        try {
+            PluginSnapshot::Write(path, aggregate_store);
+        } catch (const std::exception& e) {
+            std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
+        }
+    }
+
+    // Справочные данные и итоги дней создаются вместе; итоги восстанавливаются из снимка, чтобы
+    // первый отчет после перезапуска сервера не пересчитывал окно (вызывается под plugin_mutex)
+    void CreatePersistentState() {
+        reference_cache     = std::make_shared<ReferenceCache>();
+        day_aggregate_store = std::make_shared<DayAggregateStore>();
+        snapshot_config     = PluginSnapshotConfig::FromEnvironment();
+        snapshot_written_at = std::time(nullptr);
+
+        if (snapshot_config.path.empty()) {
+            return;
+        }
+
+        try {
+            PluginSnapshot::Load(snapshot_config.path, *day_aggregate_store);
+        } catch (const std::exception& e) {
+            // Поврежденный или устаревший снимок - отчеты строятся с нуля, как без него
+            day_aggregate_store->Clear();
+            std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
+        }
+    }
+
+    // Пул потоков создается при первом отчете и живет до выгрузки плагина
+    std::shared_ptr<ThreadPool> AcquireExecutor() {
+        std::lock_guard<std::mutex> lock(plugin_mutex);
+        if (!executor) {
+            executor = std::make_shared<ThreadPool>();
+        }
+        return executor;
+    }
+
+    // Справочные данные переживают отдельные отчеты и сбрасываются при выгрузке плагина
+    std::shared_ptr<ReferenceCache> AcquireReferenceCache() {
+        std::lock_guard<std::mutex> lock(plugin_mutex);
+        if (!reference_cache || !day_aggregate_store) {
+            CreatePersistentState();
+        }
+        return reference_cache;
+    }
+
+    std::shared_ptr<DayAggregateStore> AcquireDayAggregateStore() {
+        std::lock_guard<std::mutex> lock(plugin_mutex);
+        if (!reference_cache || !day_aggregate_store) {
+            CreatePersistentState();
+        }
+        return day_aggregate_store;
+    }
+
+    // Снимок пишется в пуле потоков не чаще интервала: запись на диск не задерживает ответ.
+    // is_forced - без ожидания интервала, чтобы в файле не остались сброшенные итоги дней
+    void ScheduleSnapshotWrite(bool is_forced = false) {
+        std::shared_ptr<DayAggregateStore> aggregate_store;
+        std::string                        path;
+
+        {
+            std::lock_guard<std::mutex> lock(plugin_mutex);
+
+            const time_t now = std::time(nullptr);
+            if (snapshot_config.path.empty() || !day_aggregate_store ||
+                (!is_forced && now - snapshot_written_at < snapshot_config.interval.count()) ||
+                is_snapshot_write_queued) {
+                return;
+            }
+
+            is_snapshot_write_queued = true;
+            snapshot_written_at      = now;
+            aggregate_store          = day_aggregate_store;
+            path                     = snapshot_config.path;
+        }
+
+        const uint64_t generation = snapshot_generation.load();
+
+        AcquireExecutor()->Submit([aggregate_store, path, generation]() {
+            is_snapshot_write_queued = false;
+            WriteSnapshot(path, *aggregate_store, generation);
+        });
+    }
+
+    std::shared_ptr<ReportResultCache> AcquireReportResultCache() {
+        std::lock_guard<std::mutex> lock(plugin_mutex);
+        if (!report_result_cache) {
+            report_result_cache = std::make_shared<ReportResultCache>();
+        }
+        return report_result_cache;
+    }
+
+    // Снимки сделок для постраничной таблицы живут между запросом отчета и запросами страниц
+    std::shared_ptr<DealsSnapshotCache> AcquireDealsSnapshots() {
+        std::lock_guard<std::mutex> lock(plugin_mutex);
+        if (!deals_snapshots) {
+            deals_snapshots = std::make_shared<DealsSnapshotCache>(
+                utils::GetEnvSeconds("DAILY_TRADES_DEALS_SNAPSHOT_TTL", std::chrono::seconds(300)),
+                utils::GetEnvSize("DAILY_TRADES_DEALS_SNAPSHOT_MAX", 16));
+        }
+        return deals_snapshots;
+    }
+
+    // Резидентное состояние групп обновляется событиями сделок между отчетами
+    std::shared_ptr<IncrementalReportState> AcquireIncrementalState() {
+        std::lock_guard<std::mutex> lock(plugin_mutex);
+        if (!incremental_state) {
+            incremental_state = std::make_shared<IncrementalReportState>();
+        }
+        return incremental_state;
+    }
+
+    // Индекс групп из кэша плагина, при промахе - с сервера
+    std::shared_ptr<const GroupIndex> GetGroupIndex(ReferenceCache&   shared_cache,
+                                                    CServerInterface* server) {
+        std::shared_ptr<const GroupIndex> group_index =
+            shared_cache.Groups().Get(ALL_GROUPS_KEY).value;
+        if (!group_index) {
+            std::vector<GroupRecord> groups;
+            server->GetAllGroups(&groups);
+            group_index = std::make_shared<const GroupIndex>(groups);
+            shared_cache.Groups().Put(ALL_GROUPS_KEY, group_index);
+        }
+        return group_index;
+    }
+
+    // Начало текущего дня пересчитывается только при смене дня: событию сделки не нужен
+    // mktime на каждый вызов
+    time_t CurrentDayStart() {
+        static std::mutex day_mutex;
+        static time_t     day_start      = 0;
+        static time_t     next_day_start = 0;
+
+        const time_t                now = std::time(nullptr);
+        std::lock_guard<std::mutex> lock(day_mutex);
+        if (now < day_start || now >= next_day_start) {
+            day_start      = utils::CalculateDayStart(now);
+            next_day_start = utils::CalculateNextDayStart(day_start);
+        }
+        return day_start;
+    }
+
+    // Сверка итогов дней состояния с пакетным расчетом. Суммы складываются в другом
+    // порядке, поэтому сравниваются с допуском; дни без сделок не сравниваются -
+    // хранилище дней держит их нулевыми, а состояние не создает
+    bool IsSameDailyAggregates(const std::map<time_t, DailyTradesAggregate>& expected,
+                               const std::map<time_t, DailyTradesAggregate>& actual) {
+        const auto is_close = [](double a, double b) {
+            return std::abs(a - b) <= 1e-6 * std::max({1.0, std::abs(a), std::abs(b)});
+        };
+        const auto is_empty = [](const DailyTradesAggregate& aggregate) {
+            return aggregate.profit_count == 0 && aggregate.loss_count == 0;
+        };
+        const auto count_days = [&is_empty](const std::map<time_t, DailyTradesAggregate>& days) {
+            return std::count_if(days.begin(), days.end(), [&is_empty](const auto& day) {
+                return !is_empty(day.second);
+            });
+        };
+
+        if (count_days(expected) != count_days(actual)) {
+            return false;
+        }
+
+        for (const auto& [day_start, aggregate] : expected) {
+            if (is_empty(aggregate)) {
+                continue;
+            }
+
+            const auto it = actual.find(day_start);
+            if (it == actual.end() || it->second.profit_count != aggregate.profit_count ||
+                it->second.loss_count != aggregate.loss_count ||
+                !is_close(it->second.profit, aggregate.profit) ||
+                !is_close(it->second.loss, aggregate.loss) ||
+                !is_close(it->second.total, aggregate.total)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Прибыль отобранных строк: списки лучших сделок сверяются по значениям,
+    // а не по номерам - при равной прибыли порядок выборок может отличаться
+    std::vector<double> SelectProfits(const TradeColumns& trades, const std::vector<size_t>& rows) {
+        std::vector<double> profits;
+        profits.reserve(rows.size());
+        for (const size_t row : rows) {
+            profits.push_back(trades.profit[row]);
+        }
+        return profits;
+    }
+
+    // Ключ снимка сделок: отчет и запросы его страниц ссылаются на один снимок
+    std::string MakeDealsKey(const std::string& group_mask, int from, int to) {
+        return group_mask + '\n' + std::to_string(from) + '\n' + std::to_string(to);
+    }
+
+    // Нормализованный запрос: все параметры, от которых зависит ответ
+    std::string MakeReportKey(const std::string& group_mask,
+                              int                from,
+                              int                to,
+                              int                top_count,
+                              int                deals_page_size) {
+        return MakeDealsKey(group_mask, from, to) + '\n' + std::to_string(top_count) + '\n' +
+               std::to_string(deals_page_size);
+    }
+
+    int ParseDealsPageSize(const rapidjson::Value& request) {
+        if (request.HasMember("page_size") && request["page_size"].IsInt()) {
+            return std::clamp(request["page_size"].GetInt(), 1, MAX_DEALS_PAGE_SIZE);
+        }
+        return DEFAULT_DEALS_PAGE_SIZE;
+    }
+
+    // Опции фильтра групп {text, value}; имя группы копируется в ответ один раз
+    Value CreateGroupFilterOptions(const GroupIndex&                   group_index,
+                                   rapidjson::Document::AllocatorType& allocator) {
+        Value options(rapidjson::kArrayType);
+        options.Reserve(static_cast<rapidjson::SizeType>(group_index.Groups().size()), allocator);
+
+        for (const auto& group : group_index.Groups()) {
+            const auto size = static_cast<rapidjson::SizeType>(group.name.size());
+            char*      name = static_cast<char*>(allocator.Malloc(size + 1));
+            std::memcpy(name, group.name.c_str(), size + 1);
+
+            Value option(rapidjson::kObjectType);
+            option.AddMember("text", rapidjson::StringRef(name, size), allocator);
+            option.AddMember("value", rapidjson::StringRef(name, size), allocator);
+            options.PushBack(option, allocator);
+        }
+
+        return options;
+    }
+
+    // Имя файла выгрузки: день, маска групп (только безопасные символы) и время выгрузки
+    std::string MakeExportFileName(const std::string& group_mask, int from, const char* extension) {
+        std::string mask = group_mask.empty() ? "all" : group_mask;
+        for (char& symbol : mask) {
+            if (!std::isalnum(static_cast<unsigned char>(symbol)) && symbol != '-') {
+                symbol = '_';
+            }
+        }
+
+        return "daily_trades_" + utils::FormatTimestampToString(from, "%Y%m%d") + "_" + mask +
+               "_" + std::to_string(std::time(nullptr)) + extension;
+    }
+
+    // Исключение не должно выйти из функции плагина через границу extern "C":
+    // частично собранный ответ заменяется ошибкой
+    void SetErrorResponse(const std::exception&               e,
+                          const char*                         message,
+                          Value&                              response,
+                          rapidjson::Document::AllocatorType& allocator) {
+        std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
+
+        response.SetObject();
+        response.AddMember("error", StringRef(message), allocator);
+    }
+
+    // Положение страницы в снимке - по нему клиент запрашивает следующие страницы
+    Value CreatePagination(size_t                              total,
+                           int                                 page,
+                           int                                 page_size,
+                           rapidjson::Document::AllocatorType& allocator) {
+        Value pagination(rapidjson::kObjectType);
+        pagination.AddMember("total", static_cast<uint64_t>(total), allocator);
+        pagination.AddMember("page", page, allocator);
+        pagination.AddMember("pageSize", page_size, allocator);
+        pagination.AddMember(
+            "pagesCount", static_cast<uint64_t>((total + page_size - 1) / page_size), allocator);
+        return pagination;
+    }
+} // namespace
+
 extern "C" void AboutReport(rapidjson::Value&                   request,
                             rapidjson::Value&                   response,
                             rapidjson::Document::AllocatorType& allocator,
@@ -18,16 +338,58 @@ extern "C" void AboutReport(rapidjson::Value&                   request,
     response.AddMember("type", REPORT_DAILY_GROUP_TYPE, allocator);
 }
 
-extern "C" void DestroyReport() {}
+extern "C" void DestroyReport() {
+    std::lock_guard<std::mutex> lock(plugin_mutex);
+
+    // Итоговый снимок пишется до очистки хранилищ; отложенные записи после него пропускаются
+    const uint64_t generation = ++snapshot_generation;
+    if (!snapshot_config.path.empty() && day_aggregate_store) {
+        WriteSnapshot(snapshot_config.path, *day_aggregate_store, generation);
+    }
+
+    if (reference_cache) {
+        reference_cache->Clear();
+        reference_cache.reset();
+    }
+
+    if (day_aggregate_store) {
+        day_aggregate_store->Clear();
+        day_aggregate_store.reset();
+    }
+
+    if (report_result_cache) {
+        report_result_cache->Clear();
+        report_result_cache.reset();
+    }
+
+    if (deals_snapshots) {
+        deals_snapshots->Clear();
+        deals_snapshots.reset();
+    }
+
+    if (incremental_state) {
+        incremental_state->Clear();
+        incremental_state.reset();
+    }
+
+    executor.reset();
+    is_snapshot_write_queued = false;
+}
 
 extern "C" void CreateReport(rapidjson::Value&                   request,
                              rapidjson::Value&                   response,
                              rapidjson::Document::AllocatorType& allocator,
-                             CServerInterface*                   server) {
+                             CServerInterface*                   server) try {
+    // Длительности этапов и счетчики: сводка уходит в LogsOut, по запросу - в ответ
+    utils::ReportMetrics metrics;
+
     std::string group_mask;
-    int         from;
-    int         to;
-    int         from_two_weeks_ago;
+    int         from                  = 0;
+    int         to                    = 0;
+    int         from_two_weeks_ago    = 0;
+    int         top_count             = 10;
+    bool        is_debug_timings      = false;
+    bool        is_verify_incremental = false;
     if (request.HasMember("group") && request["group"].IsString()) {
         group_mask = request["group"].GetString();
     }
@@ -38,376 +400,856 @@ extern "C" void CreateReport(rapidjson::Value&                   request,
     if (request.HasMember("to") && request["to"].IsNumber()) {
         to = request["to"].GetInt();
     }
+    if (request.HasMember("top_count") && request["top_count"].IsInt()) {
+        top_count = std::clamp(request["top_count"].GetInt(), 1, 1000);
+    }
+    if (request.HasMember("debug_timings") && request["debug_timings"].IsBool()) {
+        is_debug_timings = request["debug_timings"].GetBool();
+    }
+    if (request.HasMember("verify_incremental") && request["verify_incremental"].IsBool()) {
+        is_verify_incremental = request["verify_incremental"].GetBool();
+    }
+    const int deals_page_size = ParseDealsPageSize(request);
+
+    // Тот же отчет недавно уже строился - отдаем копию готового ответа. Запросы
+    // с debug_timings и verify_incremental всегда строятся заново: замеры должны быть
+    // настоящими, а сверка состояния выполняется только при пакетном расчете
+    const std::shared_ptr<ReportResultCache> result_cache = AcquireReportResultCache();
+    const std::string report_key =
+        MakeReportKey(group_mask, from, to, top_count, deals_page_size);
+    const bool is_cache_bypassed = is_debug_timings || is_verify_incremental;
+
+    if (const auto cached_response = is_cache_bypassed ? nullptr : result_cache->Find(report_key)) {
+        response.CopyFrom(*cached_response, allocator);
+        return;
+    }
 
-    std::vector<TradeRecord>       close_trades_vector;
-    std::vector<TradeRecord>       open_trades_vector;
-    std::vector<GroupRecord>       groups_vector;
-    std::vector<UsdConvertedTrade> usd_converted_close_trades_vector;
-    std::vector<UsdConvertedTrade> usd_converted_open_trades_vector;
+    // Закрытия, наблюдаемые после этой точки, могли не попасть в выборки отчета
+    const uint64_t close_generation = result_cache->Generation();
+
+    TradeColumns close_trades;
+    TradeColumns open_trades;
+
+    // Секции отчета, заполняемые за один проход по каждой выборке сделок
+    utils::TopOrdersAccumulator     close_top_orders(from, top_count);
+    utils::TopOrdersAccumulator     open_top_orders(0, top_count);
+    utils::OpenPositionsAccumulator open_positions;
+
+    const std::shared_ptr<ReferenceCache> shared_cache = AcquireReferenceCache();
+    AccountCache                          account_cache(server, shared_cache.get());
+    std::shared_ptr<const GroupIndex>     group_index = std::make_shared<const GroupIndex>();
+
+    const std::shared_ptr<const GroupIndex> cached_group_index =
+        shared_cache->Groups().Get(ALL_GROUPS_KEY).value;
+
+    // Отчет собирается из резидентного состояния, если все группы маски живые. Иначе -
+    // пакетный расчет: он заполняет состояние, если отчет включает текущий момент
+    // (дальше состояние ведут события), а по verify_incremental сверяется с состоянием
+    const std::shared_ptr<IncrementalReportState> report_state = AcquireIncrementalState();
+
+    // Состояние хранит дни целиком и не знает закрытий после текущего момента: окно должно
+    // начинаться с границ дней и включать текущий момент, иначе в итоги попадут лишние сделки,
+    // а лучшие сделки дня from отберутся раньше, чем отсечется начало окна
+    const bool is_state_window = to >= std::time(nullptr) &&
+                                 utils::CalculateDayStart(from) == from &&
+                                 utils::CalculateDayStart(from_two_weeks_ago) == from_two_weeks_ago;
+
+    const bool is_state_live =
+        report_state->IsEnabled() && is_state_window && cached_group_index &&
+        static_cast<size_t>(top_count) <= report_state->TopCount() &&
+        report_state->IsLive(*cached_group_index, group_mask, from_two_weeks_ago);
+    const bool is_state_report  = is_state_live && !is_verify_incremental;
+    const bool is_state_seeding =
+        report_state->IsEnabled() && !is_state_report && to >= std::time(nullptr);
+
+    // Итоги завершенных дней двухнедельного окна берутся из хранилища,
+    // с сервера запрашиваются только остальные дни (как минимум - выбранный день).
+    // Заполнению состояния нужны сделки всего окна, поэтому хранилище не используется
+    const std::shared_ptr<DayAggregateStore> aggregate_store  = AcquireDayAggregateStore();
+    const uint64_t                           store_generation = aggregate_store->Generation();
+
+    const time_t today_start       = utils::CalculateDayStart(std::time(nullptr));
+    time_t       close_trades_from = from_two_weeks_ago;
+
+    std::map<time_t, DailyTradesAggregate> daily_aggregates;
+
+    auto day_store_stage = metrics.Measure("day_store");
+
+    for (time_t day_start = from_two_weeks_ago; day_start < from;) {
+        const time_t next_day_start = utils::CalculateNextDayStart(day_start);
+
+        if (is_state_report || is_state_seeding ||
+            utils::CalculateDayStart(day_start) != day_start || next_day_start > today_start) {
+            break;
+        }
+
+        const auto aggregate = aggregate_store->Find(group_mask, day_start);
+        if (!aggregate) {
+            break;
+        }
+
+        daily_aggregates[day_start] = *aggregate;
+        close_trades_from           = next_day_start;
+        day_start                   = next_day_start;
+    }
+
+    day_store_stage.Stop();
+
+    bool   is_report_complete    = false;
+    time_t last_close_trade_time = 0;
+
+    // Первая страница таблицы всех сделок берется из снимка, остальные - через GetReportPage
+    std::shared_ptr<const DealsSnapshot> deals_snapshot;
+
+    // Заполнение состояния начинается до выборки: события, пришедшие во время нее,
+    // применяются к заполненному состоянию, а не теряются
+    uint64_t seed_id = 0;
 
     try {
-        server->GetCloseTradesByGroup(group_mask, from_two_weeks_ago, to, &close_trades_vector);
-        server->GetOpenTradesByGroup(group_mask, from_two_weeks_ago, to, &open_trades_vector);
-        server->GetAllGroups(&groups_vector);
+        if (is_state_report) {
+            group_index = cached_group_index;
+
+            auto accounts_stage = metrics.Measure("accounts_preload");
+            account_cache.Preload(*group_index, group_mask);
+            accounts_stage.Stop();
+
+            // Секции считаются по небольшим выборкам состояния: кандидаты в лучшие
+            // и худшие сделки периода и открытые позиции
+            auto state_stage = metrics.Measure("incremental_state");
+            report_state->Collect(group_mask,
+                                  from_two_weeks_ago,
+                                  from,
+                                  to,
+                                  daily_aggregates,
+                                  close_trades,
+                                  open_trades);
+
+            utils::RunAggregation(close_trades, {&close_top_orders});
+            utils::RunAggregation(open_trades, {&open_top_orders, &open_positions});
+            state_stage.Stop();
+
+            // Таблица всех сделок в состояние не входит: снимок берется из кэша, если после
+            // него в период не закрывались сделки, иначе запрашиваются сделки периода
+            const std::shared_ptr<DealsSnapshotCache> snapshots = AcquireDealsSnapshots();
+            const std::string deals_key = MakeDealsKey(group_mask, from, to);
+
+            deals_snapshot = snapshots->Get(deals_key).value;
+
+            const bool is_snapshot_stale =
+                deals_snapshot && result_cache->HasCloseSince(deals_snapshot->CloseGeneration(),
+                                                              from,
+                                                              to,
+                                                              deals_snapshot->LastCloseTime());
+
+            if (!deals_snapshot || is_snapshot_stale) {
+                auto deals_snapshot_stage = metrics.Measure("deals_snapshot");
+
+                std::vector<TradeRecord> trade_records;
+                server->GetCloseTradesByGroup(group_mask, from, to, &trade_records);
+
+                TradeColumns period_trades;
+                period_trades.Ingest(std::move(trade_records));
+
+                deals_snapshot = std::make_shared<const DealsSnapshot>(
+                    period_trades, from, account_cache, close_generation);
+                snapshots->Put(deals_key, deals_snapshot);
+
+                metrics.AddCounter("calls_get_close_trades", 1);
+            }
+
+            // Снимок содержит все закрытия периода - по нему и определяется устаревание ответа
+            last_close_trade_time = deals_snapshot->LastCloseTime();
 
-        for (auto& close_trade : close_trades_vector) {
-            AccountRecord account;
-            double        multiplier;
+            metrics.AddCounter("state_close_candidates", close_trades.Size());
+            metrics.AddCounter("open_trades", open_trades.Size());
+        } else {
+            // Независимые запросы к серверу выполняются параллельно
+            const std::shared_ptr<ThreadPool> executor = AcquireExecutor();
 
-            server->GetAccountByLogin(close_trade.login, &account);
+            if (is_state_seeding) {
+                seed_id = report_state->BeginSeed(group_mask);
+            }
 
-            for (const auto& group : groups_vector) {
-                if (group.group == account.group) {
-                    double usd_profit = 0.00;
+            auto close_trades_future =
+                executor->Submit([server, group_mask, close_trades_from, to]() {
+                    std::vector<TradeRecord> trades;
+                    server->GetCloseTradesByGroup(group_mask, close_trades_from, to, &trades);
+                    return trades;
+                });
+            auto open_trades_future =
+                executor->Submit([server, group_mask, from_two_weeks_ago, to]() {
+                    std::vector<TradeRecord> trades;
+                    server->GetOpenTradesByGroup(group_mask, from_two_weeks_ago, to, &trades);
+                    return trades;
+                });
+
+            auto groups_stage = metrics.Measure("groups");
+
+            if (cached_group_index) {
+                group_index = cached_group_index;
+            } else {
+                auto groups_future = executor->Submit([server]() {
+                    std::vector<GroupRecord> groups;
+                    server->GetAllGroups(&groups);
+                    return std::make_shared<const GroupIndex>(groups);
+                });
+
+                group_index = groups_future.get();
+                shared_cache->Groups().Put(ALL_GROUPS_KEY, group_index);
+                metrics.AddCounter("calls_get_all_groups", 1);
+            }
 
-                    UsdConvertedTrade converted_close_trade;
+            groups_stage.Stop();
 
-                    if (group.currency == "USD") {
-                        usd_profit = close_trade.profit;
-                    } else {
-                        server->CalculateConvertRateByCurrency(
-                            group.currency, "USD", close_trade.cmd, &multiplier);
-                        usd_profit = close_trade.profit * multiplier;
+            RateTable rate_table(server, group_index->Currencies(), shared_cache.get());
+
+            auto accounts_stage = metrics.Measure("accounts_preload");
+            account_cache.Preload(*group_index, group_mask);
+            accounts_stage.Stop();
+
+            // Ожидание выборки сделок - время, не перекрытое предыдущими этапами
+            const auto wait_trades = [&metrics](std::future<std::vector<TradeRecord>>& future) {
+                auto fetch_stage = metrics.Measure("fetch_wait");
+                return future.get();
+            };
+
+            // Проекция в колонки и конвертация прибыли в USD; исходные записи сразу освобождаются
+            const auto ingest_trades = [&](std::vector<TradeRecord>&& trade_records,
+                                           TradeColumns&              trades) {
+                auto conversion_stage = metrics.Measure("conversion");
+
+                trades.Ingest(std::move(trade_records));
+
+                for (size_t i = 0; i < trades.Size(); ++i) {
+                    const AccountRecord& account = account_cache.Get(trades.login[i]);
+                    const GroupInfo*     group   = group_index->Find(account.group);
+
+                    if (group == nullptr) {
+                        continue;
                     }
 
-                    converted_close_trade.usd_profit = usd_profit;
-                    converted_close_trade.close_time = close_trade.close_time;
+                    const double multiplier = rate_table.Get(group->currency_id, trades.cmd[i]);
 
-                    usd_converted_close_trades_vector.emplace_back(converted_close_trade);
+                    trades.usd_profit[i]   = trades.profit[i] * multiplier;
+                    trades.is_converted[i] = 1;
                 }
+            };
+
+            // Конвертируем ту выборку сделок, которая пришла первой
+            const bool is_open_trades_first =
+                open_trades_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+                close_trades_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+
+            if (is_open_trades_first) {
+                ingest_trades(wait_trades(open_trades_future), open_trades);
             }
-        }
 
-        for (const auto& open_trade : open_trades_vector) {
-            AccountRecord account;
-            double        multiplier;
+            ingest_trades(wait_trades(close_trades_future), close_trades);
 
-            server->GetAccountByLogin(open_trade.login, &account);
+            if (close_trades.Size() > 0) {
+                last_close_trade_time = *std::max_element(close_trades.close_time.begin(),
+                                                          close_trades.close_time.end());
+                result_cache->ObserveCloseTime(last_close_trade_time);
+            }
 
-            for (const auto& group : groups_vector) {
-                if (group.group == account.group) {
-                    double usd_profit = 0.00;
+            auto closed_aggregation_stage = metrics.Measure("aggregation");
 
-                    UsdConvertedTrade converted_close_trade;
+            std::map<time_t, DailyTradesAggregate> fetched_aggregates;
+            const utils::DayBucketer               day_buckets(close_trades_from, to);
+            utils::DailyAggregateAccumulator       daily_accumulator(fetched_aggregates,
+                                                                     day_buckets);
 
-                    if (group.currency == "USD") {
-                        usd_profit = open_trade.profit;
-                    } else {
-                        server->CalculateConvertRateByCurrency(
-                            group.currency, "USD", open_trade.cmd, &multiplier);
-                        usd_profit = open_trade.profit * multiplier;
-                    }
+            utils::RunAggregation(
+                close_trades, {&daily_accumulator, &close_top_orders}, executor.get());
+
+            // Полностью прошедшие дни запоминаются, включая дни без сделок
+            for (time_t day_start = close_trades_from; day_start < today_start;) {
+                const time_t next_day_start = utils::CalculateNextDayStart(day_start);
+
+                if (next_day_start > today_start || next_day_start - 1 > to) {
+                    break;
+                }
+
+                if (day_start >= from_two_weeks_ago &&
+                    utils::CalculateDayStart(day_start) == day_start) {
+                    const auto it = fetched_aggregates.find(day_start);
+                    aggregate_store->Put(group_mask,
+                                         day_start,
+                                         it == fetched_aggregates.end() ? DailyTradesAggregate{}
+                                                                        : it->second,
+                                         store_generation);
+                }
+
+                day_start = next_day_start;
+            }
+
+            daily_aggregates.merge(fetched_aggregates);
+
+            closed_aggregation_stage.Stop();
 
-                    converted_close_trade.usd_profit = usd_profit;
-                    converted_close_trade.close_time = open_trade.close_time;
+            auto deals_snapshot_stage = metrics.Measure("deals_snapshot");
+            deals_snapshot = std::make_shared<const DealsSnapshot>(
+                close_trades, from, account_cache, close_generation);
+            AcquireDealsSnapshots()->Put(MakeDealsKey(group_mask, from, to), deals_snapshot);
+            deals_snapshot_stage.Stop();
+
+            if (!is_open_trades_first) {
+                ingest_trades(wait_trades(open_trades_future), open_trades);
+            }
 
-                    usd_converted_open_trades_vector.emplace_back(converted_close_trade);
+            auto open_aggregation_stage = metrics.Measure("aggregation");
+            utils::RunAggregation(open_trades, {&open_top_orders, &open_positions}, executor.get());
+            open_aggregation_stage.Stop();
+
+            if (is_state_live && is_verify_incremental) {
+                auto verify_stage = metrics.Measure("incremental_verify");
+
+                std::map<time_t, DailyTradesAggregate> state_aggregates;
+                TradeColumns                           state_close_trades;
+                TradeColumns                           state_open_trades;
+                report_state->Collect(group_mask,
+                                      from_two_weeks_ago,
+                                      from,
+                                      to,
+                                      state_aggregates,
+                                      state_close_trades,
+                                      state_open_trades);
+
+                utils::TopOrdersAccumulator state_close_top_orders(from, top_count);
+                utils::RunAggregation(state_close_trades, {&state_close_top_orders});
+
+                // Курсы открытых позиций состояния - на момент события, поэтому позиции
+                // сверяются по количеству, а не по сумме
+                const bool is_consistent =
+                    IsSameDailyAggregates(daily_aggregates, state_aggregates) &&
+                    SelectProfits(close_trades, close_top_orders.TopProfit()) ==
+                        SelectProfits(state_close_trades, state_close_top_orders.TopProfit()) &&
+                    SelectProfits(close_trades, close_top_orders.TopLoss()) ==
+                        SelectProfits(state_close_trades, state_close_top_orders.TopLoss()) &&
+                    open_trades.Size() == state_open_trades.Size();
+
+                metrics.AddCounter("incremental_mismatch", is_consistent ? 0 : 1);
+
+                if (!is_consistent) {
+                    server->LogsOut("WARN",
+                                    "[DailyTradesReportInterface]: incremental state of '" +
+                                        group_mask + "' diverged from the batch report, reset");
+
+                    // Без заполнения ниже группы пересчитываются пакетно до следующего заполнения
+                    report_state->InvalidateMask(group_mask);
                 }
             }
+
+            if (is_state_seeding) {
+                auto seed_stage = metrics.Measure("incremental_seed");
+                report_state->Seed(seed_id,
+                                   *group_index,
+                                   group_mask,
+                                   from_two_weeks_ago,
+                                   close_trades,
+                                   open_trades,
+                                   account_cache);
+            }
+
+            metrics.AddCounter("closed_trades", close_trades.Size());
+            metrics.AddCounter("open_trades", open_trades.Size());
+            metrics.AddCounter("calls_get_close_trades", 1);
+            metrics.AddCounter("calls_get_open_trades", 1);
+            metrics.AddCounter("calls_convert_rate", rate_table.ServerCalls());
+
+            server->LogsOut("INFO",
+                            "[DailyTradesReportInterface]: conversion rates requested " +
+                                std::to_string(rate_table.ServerCalls()) + " times, saved " +
+                                std::to_string(rate_table.SavedCalls()) + " server calls");
+            server->LogsOut("INFO",
+                            "[DailyTradesReportInterface]: reference cache " +
+                                shared_cache->FormatStats());
         }
+
+        is_report_complete = true;
     } catch (const std::exception& e) {
         std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
     }
 
-    // Profit / Lose chart
-    const JSONArray pnl_chart_data = utils::CreatePnlChartData(usd_converted_close_trades_vector);
-
-    Node pnl_chart_node = ResponsiveContainer(
-        {LineChart(
-            {XAxis({}, props({{"dataKey", "day"}})),
-             YAxis(),
-             Tooltip(),
-             Legend(),
+    // После Seed ничего не делает; при ошибке выборки события больше не запоминаются
+    if (seed_id != 0) {
+        report_state->CancelSeed(seed_id);
+    }
 
-             Line({}, props({{"type", "monotone"}, {"dataKey", "profit"}, {"stroke", "#4A90E2"}})),
+    metrics.AddCounter("calls_get_accounts_by_group", account_cache.GroupCalls());
+    metrics.AddCounter("calls_get_account_by_login", account_cache.LoginCalls());
 
-             Line({}, props({{"type", "monotone"}, {"dataKey", "loss"}, {"stroke", "#7ED321"}})),
+    // Каркас ответа готов с загрузки плагина: копируются только узлы, строки остаются
+    // ссылками на литералы; отчет лишь подставляет данные графиков и props таблиц
+    auto ui_stage = metrics.Measure("ui");
+    report_layout.Instantiate(response, allocator);
+    ui_stage.Stop();
 
-             Line(
-                 {},
-                 props({{"type", "monotone"}, {"dataKey", "profit/loss"}, {"stroke", "#F5A623"}}))},
-            props({{"data", pnl_chart_data}}))},
-        props({{"width", "100%"}, {"height", 300.0}}));
+    const auto fill_table = [&](utils::ReportSlot slot, TableBuilder&& builder) {
+        Value table_props;
+        std::move(builder).Finalize(table_props, allocator);
+        report_layout.Fill(response, slot, std::move(table_props));
+    };
 
-    // Clients trades count chart
-    const JSONArray trades_count_chart_data =
-        utils::CreateTradesCountChartData(close_trades_vector);
+    auto charts_stage = metrics.Measure("charts");
 
-    Node trades_count_chart_node = ResponsiveContainer(
-        {LineChart(
-            {
-                XAxis({}, props({{"dataKey", "day"}})),
-                YAxis(),
-                Tooltip(),
-                Legend(),
+    report_layout.Fill(response,
+                       utils::ReportSlot::PnlChartData,
+                       utils::CreatePnlChartData(daily_aggregates, allocator));
+    report_layout.Fill(response,
+                       utils::ReportSlot::TradesCountChartData,
+                       utils::CreateTradesCountChartData(daily_aggregates, allocator));
+    report_layout.Fill(response,
+                       utils::ReportSlot::OpenPositionsPieData,
+                       utils::CreateOpenPositionsPieChartData(open_positions.Totals(), allocator));
 
-                Line({},
-                     props({{"type", "monotone"}, {"dataKey", "profit"}, {"stroke", "#4A90E2"}})),
+    charts_stage.Stop();
 
-                Line({}, props({{"type", "monotone"}, {"dataKey", "loss"}, {"stroke", "#7ED321"}})),
-            },
-            props({{"data", trades_count_chart_data}}))},
-        props({{"width", "100%"}, {"height", 300.0}}));
+    auto tables_stage = metrics.Measure("tables");
 
     // Table filters
     FilterConfig search_filter;
     search_filter.type = FilterType::Search;
 
-    FilterConfig date_time_filter;
-    date_time_filter.type = FilterType::DateTime;
-
+    // Опции фильтра групп одинаковы во всех таблицах: они передаются один раз
+    // в словаре filter_options ответа, колонки ссылаются на него по имени
     FilterConfig group_select_filter;
-    group_select_filter.type = FilterType::Select;
-    for (const auto& group : groups_vector) {
-        group_select_filter.options.push_back({group.group, group.group});
-    }
-
-    // Top close profit orders table
-    std::vector<TradeRecord> top_close_profit_orders_vector =
-        utils::CreateTopProfitOrdersVector(close_trades_vector);
-    TableBuilder top_close_profit_orders_table_builder("TopCloseProfitOrdersTable");
-
-    // Table props
-    top_close_profit_orders_table_builder.SetIdColumn("order");
-    top_close_profit_orders_table_builder.SetOrderBy("profit", "DESC");
-    top_close_profit_orders_table_builder.EnableAutoSave(false);
-    top_close_profit_orders_table_builder.EnableRefreshButton(false);
-    top_close_profit_orders_table_builder.EnableBookmarksButton(false);
-    top_close_profit_orders_table_builder.EnableExportButton(true);
-
-    // Columns
-    top_close_profit_orders_table_builder.AddColumn({"order", "ORDER", 1, search_filter});
-    top_close_profit_orders_table_builder.AddColumn({"login", "LOGIN", 2, search_filter});
-    top_close_profit_orders_table_builder.AddColumn({"name", "NAME", 3, search_filter});
-    top_close_profit_orders_table_builder.AddColumn({"symbol", "SYMBOL", 4, search_filter});
-    top_close_profit_orders_table_builder.AddColumn({"group", "GROUP", 5, group_select_filter});
-    top_close_profit_orders_table_builder.AddColumn({"type", "TYPE", 6});
-    top_close_profit_orders_table_builder.AddColumn({"volume", "VOLUME", 7, search_filter});
-    top_close_profit_orders_table_builder.AddColumn(
-        {"close_price", "CLOSE_PRICE", 8, search_filter});
-    top_close_profit_orders_table_builder.AddColumn({"storage", "SWAP", 9, search_filter});
-    top_close_profit_orders_table_builder.AddColumn({"profit", "AMOUNT", 10, search_filter});
-
-    for (const auto& trade : top_close_profit_orders_vector) {
-        AccountRecord account;
+    group_select_filter.type        = FilterType::Select;
+    group_select_filter.options_ref = "groups";
+    if (group_index->Groups().size() >= VIRTUALIZED_OPTIONS_THRESHOLD) {
+        group_select_filter.is_virtualized_options = true;
+    }
 
-        try {
-            server->GetAccountByLogin(trade.login, &account);
-        } catch (const std::exception& e) {
-            std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
+    Value filter_options(rapidjson::kObjectType);
+    filter_options.AddMember(
+        "groups", CreateGroupFilterOptions(*group_index, allocator), allocator);
+    response.AddMember("filter_options", filter_options, allocator);
+
+    // Таблица топ-ордеров: четыре таблицы отличаются именем, сортировкой и колонкой цены
+    const auto fill_top_orders_table = [&](utils::ReportSlot          slot,
+                                           const char*                name,
+                                           const char*                order,
+                                           const char*                price_column,
+                                           const char*                price_title,
+                                           const TradeColumns&        trades,
+                                           const std::vector<size_t>& rows) {
+        TableBuilder builder(name);
+
+        // Table props
+        builder.SetIdColumn("order");
+        builder.SetOrderBy("profit", order);
+        builder.EnableAutoSave(false);
+        builder.EnableRefreshButton(false);
+        builder.EnableBookmarksButton(false);
+        builder.EnableExportButton(true);
+
+        // Columns
+        builder.AddColumn({"order", "ORDER", 1, search_filter}, ColumnType::Int64);
+        builder.AddColumn({"login", "LOGIN", 2, search_filter}, ColumnType::Int64);
+        builder.AddColumn({"name", "NAME", 3, search_filter});
+        builder.AddColumn({"symbol", "SYMBOL", 4, search_filter});
+        builder.AddColumn({"group", "GROUP", 5, group_select_filter});
+        builder.AddColumn({"type", "TYPE", 6, std::nullopt});
+        builder.AddColumn({"volume", "VOLUME", 7, search_filter}, ColumnType::Double, 2);
+        builder.AddColumn({price_column, price_title, 8, search_filter}, ColumnType::Double, 2);
+        builder.AddColumn({"storage", "SWAP", 9, search_filter}, ColumnType::Double, 2);
+        builder.AddColumn({"profit", "AMOUNT", 10, search_filter}, ColumnType::Double, 2);
+
+        builder.ReserveRows(rows.size());
+        for (const size_t row : rows) {
+            const AccountRecord& account = account_cache.Get(trades.login[row]);
+
+            builder.AddInt(trades.order[row]);
+            builder.AddInt(trades.login[row]);
+            builder.AddString(account.name);
+            builder.AddString(trades.symbols.Get(trades.symbol_id[row]));
+            builder.AddString(account.group);
+            builder.AddString(trades.cmd[row] == 0 ? "buy" : "sell");
+            builder.AddDouble(trades.volume[row] / 100.0);
+            builder.AddDouble(trades.close_price[row]);
+            builder.AddDouble(trades.storage[row]);
+            builder.AddDouble(trades.profit[row]);
         }
 
-        top_close_profit_orders_table_builder.AddRow({
-            utils::TruncateDouble(trade.order, 0),
-            utils::TruncateDouble(trade.login, 0),
-            account.name,
-            trade.symbol,
-            account.group,
-            trade.cmd == 0 ? "buy" : "sell",
-            utils::TruncateDouble(trade.volume / 100.0, 2),
-            utils::TruncateDouble(trade.close_price, 2),
-            utils::TruncateDouble(trade.storage, 2),
-            utils::TruncateDouble(trade.profit, 2),
-        });
+        fill_table(slot, std::move(builder));
+    };
+
+    fill_top_orders_table(utils::ReportSlot::TopCloseProfitTable,
+                          "TopCloseProfitOrdersTable",
+                          "DESC",
+                          "close_price",
+                          "CLOSE_PRICE",
+                          close_trades,
+                          close_top_orders.TopProfit());
+    fill_top_orders_table(utils::ReportSlot::TopCloseLossTable,
+                          "TopCloseLossOrdersTable",
+                          "ASC",
+                          "close_price",
+                          "CLOSE_PRICE",
+                          close_trades,
+                          close_top_orders.TopLoss());
+    fill_top_orders_table(utils::ReportSlot::TopOpenProfitTable,
+                          "TopOpenProfitOrdersTable",
+                          "DESC",
+                          "open_price",
+                          "OPEN_PRICE",
+                          open_trades,
+                          open_top_orders.TopProfit());
+    fill_top_orders_table(utils::ReportSlot::TopOpenLossTable,
+                          "TopOpenLossOrdersTable",
+                          "ASC",
+                          "open_price",
+                          "CLOSE_PRICE",
+                          open_trades,
+                          open_top_orders.TopLoss());
+
+    // All deals table (first page)
+    TableBuilder all_deals_table_builder("AllDealsTable");
+
+    all_deals_table_builder.SetIdColumn("order");
+    all_deals_table_builder.SetOrderBy("close_time", "DESC");
+    all_deals_table_builder.EnableAutoSave(false);
+    all_deals_table_builder.EnableRefreshButton(false);
+    all_deals_table_builder.EnableBookmarksButton(false);
+    all_deals_table_builder.EnableExportButton(true);
+
+    DealsSnapshot::AddColumns(all_deals_table_builder, group_select_filter);
+
+    const size_t deals_count = deals_snapshot ? deals_snapshot->Size() : 0;
+    if (deals_snapshot) {
+        deals_snapshot->WritePage(0, deals_page_size, all_deals_table_builder);
     }
 
-    const JSONObject top_close_profit_orders_table_props =
-        top_close_profit_orders_table_builder.CreateTableProps();
-    const Node top_close_profit_orders_table_node = Table({}, top_close_profit_orders_table_props);
-
-    // Top close loss orders table
-    std::vector<TradeRecord> top_close_loss_orders_vector =
-        utils::CreateTopLossOrdersVector(close_trades_vector);
-    TableBuilder top_close_loss_orders_table_builder("TopCloseLossOrdersTable");
-
-    // Table props
-    top_close_loss_orders_table_builder.SetIdColumn("order");
-    top_close_loss_orders_table_builder.SetOrderBy("profit", "ASC");
-    top_close_loss_orders_table_builder.EnableAutoSave(false);
-    top_close_loss_orders_table_builder.EnableRefreshButton(false);
-    top_close_loss_orders_table_builder.EnableBookmarksButton(false);
-    top_close_loss_orders_table_builder.EnableExportButton(true);
-
-    // Columns
-    top_close_loss_orders_table_builder.AddColumn({"order", "ORDER", 1, search_filter});
-    top_close_loss_orders_table_builder.AddColumn({"login", "LOGIN", 2, search_filter});
-    top_close_loss_orders_table_builder.AddColumn({"name", "NAME", 3, search_filter});
-    top_close_loss_orders_table_builder.AddColumn({"symbol", "SYMBOL", 4, search_filter});
-    top_close_loss_orders_table_builder.AddColumn({"group", "GROUP", 5, group_select_filter});
-    top_close_loss_orders_table_builder.AddColumn({"type", "TYPE", 6});
-    top_close_loss_orders_table_builder.AddColumn({"volume", "VOLUME", 7, search_filter});
-    top_close_loss_orders_table_builder.AddColumn({"close_price", "CLOSE_PRICE", 8, search_filter});
-    top_close_loss_orders_table_builder.AddColumn({"storage", "SWAP", 9, search_filter});
-    top_close_loss_orders_table_builder.AddColumn({"profit", "AMOUNT", 10, search_filter});
-
-    for (const auto& trade : top_close_loss_orders_vector) {
-        AccountRecord account;
+    Value all_deals_table_props;
+    std::move(all_deals_table_builder).Finalize(all_deals_table_props, allocator);
+    all_deals_table_props.AddMember(
+        "pagination", CreatePagination(deals_count, 0, deals_page_size, allocator), allocator);
+    report_layout.Fill(
+        response, utils::ReportSlot::AllDealsTable, std::move(all_deals_table_props));
 
-        try {
-            server->GetAccountByLogin(trade.login, &account);
-        } catch (const std::exception& e) {
-            std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
-        }
+    metrics.AddCounter("deals", deals_count);
 
-        top_close_loss_orders_table_builder.AddRow({
-            utils::TruncateDouble(trade.order, 0),
-            utils::TruncateDouble(trade.login, 0),
-            account.name,
-            trade.symbol,
-            account.group,
-            trade.cmd == 0 ? "buy" : "sell",
-            utils::TruncateDouble(trade.volume / 100.0, 2),
-            utils::TruncateDouble(trade.close_price, 2),
-            utils::TruncateDouble(trade.storage, 2),
-            utils::TruncateDouble(trade.profit, 2),
-        });
+    tables_stage.Stop();
+
+    // Размер ответа считается сериализацией, поэтому только для диагностического запроса
+    if (is_debug_timings) {
+        metrics.AddCounter("response_bytes", utils::CalculateJsonSize(response));
     }
 
-    const JSONObject top_close_loss_orders_table_props =
-        top_close_loss_orders_table_builder.CreateTableProps();
-    const Node top_close_loss_orders_table_node = Table({}, top_close_loss_orders_table_props);
-
-    // Total current positions chart
-    const JSONArray current_positions_chart_data =
-        utils::CreateOpenPositionsPieChartData(usd_converted_open_trades_vector);
-
-    Node current_positions_pie_chart =
-        ResponsiveContainer({PieChart({Tooltip(),
-                                       Legend(),
-                                       Pie(
-                                           {
-                                               Cell({}, props({{"fill", "#4A90E2"}})), // profit
-                                               Cell({}, props({{"fill", "#7ED321"}})), // lose
-                                           },
-                                           props({{"dataKey", "value"},
-                                                  {"nameKey", "name"},
-                                                  {"data", current_positions_chart_data},
-                                                  {"cx", "50%"},
-                                                  {"cy", "50%"},
-                                                  {"outerRadius", 100.0},
-                                                  {"label", true}}))})},
-                            props({{"width", "100%"}, {"height", 300.0}}));
-
-    // Top open profit orders table
-    std::vector<TradeRecord> top_open_profit_orders_vector =
-        utils::CreateTopProfitOrdersVector(open_trades_vector);
-    TableBuilder top_open_profit_orders_table_builder("TopOpenProfitOrdersTable");
-
-    // Table props
-    top_open_profit_orders_table_builder.SetIdColumn("order");
-    top_open_profit_orders_table_builder.SetOrderBy("profit", "DESC");
-    top_open_profit_orders_table_builder.EnableAutoSave(false);
-    top_open_profit_orders_table_builder.EnableRefreshButton(false);
-    top_open_profit_orders_table_builder.EnableBookmarksButton(false);
-    top_open_profit_orders_table_builder.EnableExportButton(true);
-
-    // Columns
-    top_open_profit_orders_table_builder.AddColumn({"order", "ORDER", 1, search_filter});
-    top_open_profit_orders_table_builder.AddColumn({"login", "LOGIN", 2, search_filter});
-    top_open_profit_orders_table_builder.AddColumn({"name", "NAME", 3, search_filter});
-    top_open_profit_orders_table_builder.AddColumn({"symbol", "SYMBOL", 4, search_filter});
-    top_open_profit_orders_table_builder.AddColumn({"group", "GROUP", 5, group_select_filter});
-    top_open_profit_orders_table_builder.AddColumn({"type", "TYPE", 6});
-    top_open_profit_orders_table_builder.AddColumn({"volume", "VOLUME", 7, search_filter});
-    top_open_profit_orders_table_builder.AddColumn({"open_price", "OPEN_PRICE", 8, search_filter});
-    top_open_profit_orders_table_builder.AddColumn({"storage", "SWAP", 9, search_filter});
-    top_open_profit_orders_table_builder.AddColumn({"profit", "AMOUNT", 10, search_filter});
-
-    for (const auto& trade : top_open_profit_orders_vector) {
-        AccountRecord account;
+    server->LogsOut("INFO", "[DailyTradesReportInterface]: timings " + metrics.Format());
+
+    if (is_debug_timings) {
+        response.AddMember("debug_timings", metrics.ToJson(allocator), allocator);
+    }
 
+    // Ответ с ошибкой получения данных и диагностический ответ не кэшируются
+    if (is_report_complete && !is_debug_timings) {
+        result_cache->Put(
+            report_key, response, from, to, last_close_trade_time, close_generation);
+    }
+
+    if (is_report_complete) {
+        ScheduleSnapshotWrite();
+    }
+} catch (const std::exception& e) {
+    SetErrorResponse(e, "failed to build report", response, allocator);
+}
+
+extern "C" void GetReportPage(rapidjson::Value&                   request,
+                              rapidjson::Value&                   response,
+                              rapidjson::Document::AllocatorType& allocator,
+                              CServerInterface*                   server) try {
+    std::string group_mask;
+    int         from = 0;
+    int         to   = 0;
+    int         page = 0;
+    if (request.HasMember("group") && request["group"].IsString()) {
+        group_mask = request["group"].GetString();
+    }
+    if (request.HasMember("from") && request["from"].IsNumber()) {
+        from = request["from"].GetInt();
+    }
+    if (request.HasMember("to") && request["to"].IsNumber()) {
+        to = request["to"].GetInt();
+    }
+    if (request.HasMember("page") && request["page"].IsInt()) {
+        page = std::max(request["page"].GetInt(), 0);
+    }
+    const int page_size = ParseDealsPageSize(request);
+
+    const std::shared_ptr<DealsSnapshotCache> snapshots = AcquireDealsSnapshots();
+    const std::string                         deals_key = MakeDealsKey(group_mask, from, to);
+
+    std::shared_ptr<const DealsSnapshot> snapshot = snapshots->Get(deals_key).value;
+
+    // Снимок вытеснен или истек - сделки выбранного дня запрашиваются заново
+    if (!snapshot) {
         try {
-            server->GetAccountByLogin(trade.login, &account);
+            const uint64_t close_generation = AcquireReportResultCache()->Generation();
+
+            const std::shared_ptr<ReferenceCache> shared_cache = AcquireReferenceCache();
+            AccountCache                          account_cache(server, shared_cache.get());
+
+            const std::shared_ptr<const GroupIndex> group_index =
+                GetGroupIndex(*shared_cache, server);
+
+            account_cache.Preload(*group_index, group_mask);
+
+            std::vector<TradeRecord> trade_records;
+            server->GetCloseTradesByGroup(group_mask, from, to, &trade_records);
+
+            TradeColumns trades;
+            trades.Ingest(std::move(trade_records));
+
+            snapshot = std::make_shared<const DealsSnapshot>(
+                trades, from, account_cache, close_generation);
+            snapshots->Put(deals_key, snapshot);
         } catch (const std::exception& e) {
             std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
         }
+    }
 
-        top_open_profit_orders_table_builder.AddRow({
-            utils::TruncateDouble(trade.order, 0),
-            utils::TruncateDouble(trade.login, 1),
-            account.name,
-            trade.symbol,
-            account.group,
-            trade.cmd == 0 ? "buy" : "sell",
-            utils::TruncateDouble(trade.volume / 100.0, 2),
-            utils::TruncateDouble(trade.close_price, 2),
-            utils::TruncateDouble(trade.storage, 2),
-            utils::TruncateDouble(trade.profit, 2),
-        });
+    FilterConfig group_select_filter;
+    group_select_filter.type = FilterType::Select;
+
+    TableBuilder page_builder("AllDealsTable");
+    DealsSnapshot::AddColumns(page_builder, group_select_filter);
+
+    const size_t deals_count = snapshot ? snapshot->Size() : 0;
+    if (snapshot) {
+        snapshot->WritePage(page, page_size, page_builder);
     }
 
-    const JSONObject top_open_profit_orders_table_props =
-        top_open_profit_orders_table_builder.CreateTableProps();
-    const Node top_open_profit_orders_table_node = Table({}, top_open_profit_orders_table_props);
-
-    // Top open loss orders table
-    std::vector<TradeRecord> top_open_loss_orders_vector =
-        utils::CreateTopLossOrdersVector(open_trades_vector);
-    TableBuilder top_open_loss_orders_table_builder("TopOpenLossOrdersTable");
-
-    // Table props
-    top_open_loss_orders_table_builder.SetIdColumn("order");
-    top_open_loss_orders_table_builder.SetOrderBy("profit", "ASC");
-    top_open_loss_orders_table_builder.EnableAutoSave(false);
-    top_open_loss_orders_table_builder.EnableRefreshButton(false);
-    top_open_loss_orders_table_builder.EnableBookmarksButton(false);
-    top_open_loss_orders_table_builder.EnableExportButton(true);
-
-    top_open_loss_orders_table_builder.AddColumn({"order", "ORDER", 1, search_filter});
-    top_open_loss_orders_table_builder.AddColumn({"login", "LOGIN", 2, search_filter});
-    top_open_loss_orders_table_builder.AddColumn({"name", "NAME", 3, search_filter});
-    top_open_loss_orders_table_builder.AddColumn({"symbol", "SYMBOL", 4, search_filter});
-    top_open_loss_orders_table_builder.AddColumn({"group", "GROUP", 5, group_select_filter});
-    top_open_loss_orders_table_builder.AddColumn({"type", "TYPE", 6});
-    top_open_loss_orders_table_builder.AddColumn({"volume", "VOLUME", 7, search_filter});
-    top_open_loss_orders_table_builder.AddColumn({"open_price", "CLOSE_PRICE", 8, search_filter});
-    top_open_loss_orders_table_builder.AddColumn({"storage", "SWAP", 9, search_filter});
-    top_open_loss_orders_table_builder.AddColumn({"profit", "AMOUNT", 10, search_filter});
-
-    for (const auto& trade : top_open_loss_orders_vector) {
-        AccountRecord account;
+    Value page_props;
+    std::move(page_builder).Finalize(page_props, allocator);
 
-        try {
-            server->GetAccountByLogin(trade.login, &account);
-        } catch (const std::exception& e) {
-            std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
+    response.SetObject();
+    response.AddMember("data", page_props["data"], allocator);
+    response.AddMember(
+        "pagination", CreatePagination(deals_count, page, page_size, allocator), allocator);
+} catch (const std::exception& e) {
+    SetErrorResponse(e, "failed to build report page", response, allocator);
+}
+
+extern "C" void ExportReport(rapidjson::Value&                   request,
+                             rapidjson::Value&                   response,
+                             rapidjson::Document::AllocatorType& allocator,
+                             CServerInterface*                   server) {
+    std::string group_mask;
+    int         from               = 0;
+    int         to                 = 0;
+    int         from_two_weeks_ago = 0;
+    bool        is_tsv             = false;
+    if (request.HasMember("group") && request["group"].IsString()) {
+        group_mask = request["group"].GetString();
+    }
+    if (request.HasMember("from") && request["from"].IsNumber()) {
+        from               = request["from"].GetInt();
+        from_two_weeks_ago = utils::CalculateTimestampForTwoWeeksAgo(from);
+    }
+    if (request.HasMember("to") && request["to"].IsNumber()) {
+        to = request["to"].GetInt();
+    }
+    if (request.HasMember("format") && request["format"].IsString()) {
+        is_tsv = std::strcmp(request["format"].GetString(), "tsv") == 0;
+    }
+
+    response.SetObject();
+
+    const char* export_dir = std::getenv("DAILY_TRADES_EXPORT_DIR");
+    if (export_dir == nullptr || *export_dir == '\0') {
+        response.AddMember("error", "DAILY_TRADES_EXPORT_DIR is not set", allocator);
+        return;
+    }
+
+    // Файл появляется под итоговым именем только после успешной записи
+    const std::string path = std::string(export_dir) + "/" +
+                             MakeExportFileName(group_mask, from, is_tsv ? ".tsv" : ".csv");
+    const std::string part_path = path + ".part";
+
+    utils::DelimitedWriter writer(part_path, is_tsv ? '\t' : ',');
+    if (!writer.IsOpen()) {
+        response.AddMember("error", "failed to create export file", allocator);
+        return;
+    }
+
+    for (const char* title : {"kind", "order", "login", "name", "group", "symbol", "type",
+                              "volume", "open_time", "close_time", "open_price", "close_price",
+                              "swap", "profit"}) {
+        writer.String(title);
+    }
+    writer.EndRow();
+
+    bool is_export_complete = false;
+
+    try {
+        const std::shared_ptr<ReferenceCache> shared_cache = AcquireReferenceCache();
+        AccountCache                          account_cache(server, shared_cache.get());
+
+        const std::shared_ptr<const GroupIndex> group_index = GetGroupIndex(*shared_cache, server);
+
+        const auto write_trades = [&](const char*                     kind,
+                                      const std::string&              group_name,
+                                      const std::vector<TradeRecord>& trades) {
+            for (const TradeRecord& trade : trades) {
+                writer.String(kind);
+                writer.Int(trade.order);
+                writer.Int(trade.login);
+                writer.String(account_cache.Get(trade.login).name);
+                writer.String(group_name);
+                writer.String(trade.symbol);
+                writer.String(trade.cmd == 0 ? "buy" : "sell");
+                writer.Fixed(trade.volume / 100.0, 2);
+                writer.Timestamp(trade.open_time);
+                writer.Timestamp(trade.close_time);
+                writer.Fixed(trade.open_price, trade.digits);
+                writer.Fixed(trade.close_price, trade.digits);
+                writer.Fixed(trade.storage, 2);
+                writer.Fixed(trade.profit, 2);
+                writer.EndRow();
+            }
+        };
+
+        // Сделки запрашиваются и записываются по одной группе: в памяти не больше
+        // сделок одной группы, буфер выборки переиспользуется
+        std::vector<TradeRecord> trades;
+
+        for (const auto& group : group_index->Groups()) {
+            if (!utils::MatchGroupMask(group_mask, group.name)) {
+                continue;
+            }
+
+            account_cache.Preload(*group_index, group.name);
+
+            trades.clear();
+            server->GetCloseTradesByGroup(group.name, from, to, &trades);
+            write_trades("closed", group.name, trades);
+
+            trades.clear();
+            server->GetOpenTradesByGroup(group.name, from_two_weeks_ago, to, &trades);
+            write_trades("open", group.name, trades);
         }
 
-        top_open_loss_orders_table_builder.AddRow({
-            utils::TruncateDouble(trade.order, 0),
-            utils::TruncateDouble(trade.login, 0),
-            account.name,
-            trade.symbol,
-            account.group,
-            trade.cmd == 0 ? "buy" : "sell",
-            utils::TruncateDouble(trade.volume / 100.0, 2),
-            utils::TruncateDouble(trade.close_price, 2),
-            utils::TruncateDouble(trade.storage, 2),
-            utils::TruncateDouble(trade.profit, 2),
-        });
+        is_export_complete = true;
+    } catch (const std::exception& e) {
+        std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
     }
 
-    const JSONObject top_open_loss_orders_table_props =
-        top_open_loss_orders_table_builder.CreateTableProps();
-    const Node top_open_loss_orders_table_node = Table({}, top_open_loss_orders_table_props);
-
-    // Total report
-    const Node report =
-        Column({h1({text("Daily Trades Report")}),
-                h2({text("Profit and Loss of Clients, USD")}),
-                pnl_chart_node,
-                h2({text("Client Trades Count")}),
-                trades_count_chart_node,
-                h2({text("Top Close Profit Orders")}),
-                top_close_profit_orders_table_node,
-                h2({text("Top Close Loss Orders")}),
-                top_close_loss_orders_table_node,
-                h2({text("Total Profit/Loss of Current Client Positions, USD (%)")}),
-                current_positions_pie_chart,
-                h2({text("Top Open Profit Orders")}),
-                top_open_profit_orders_table_node,
-                h2({text("Top Open Loss Orders")}),
-                top_open_loss_orders_table_node});
-
-    utils::CreateUI(report, response, allocator);
-}
\ No newline at end of file
+    const bool is_written = writer.Close();
+
+    if (!is_export_complete || !is_written || std::rename(part_path.c_str(), path.c_str()) != 0) {
+        std::remove(part_path.c_str());
+        response.AddMember("error", "failed to write export file", allocator);
+        return;
+    }
+
+    server->LogsOut("INFO",
+                    "[DailyTradesReportInterface]: exported " + std::to_string(writer.Rows() - 1) +
+                        " trades to " + path);
+
+    Value export_info(rapidjson::kObjectType);
+    export_info.AddMember("path", Value(path.c_str(), allocator), allocator);
+    export_info.AddMember("bytes", writer.Bytes(), allocator);
+    export_info.AddMember("rows", writer.Rows() - 1, allocator);
+    export_info.AddMember("format", is_tsv ? "tsv" : "csv", allocator);
+    response.AddMember("export", export_info, allocator);
+}
+
+extern "C" void OnTradeEvent(EventRecordType    record_type,
+                             const TradeRecord& trade,
+                             CServerInterface*  server) {
+    const bool is_closed = trade.close_time != 0;
+
+    // Закрытие сделки делает устаревшими кэшированные отчеты, в период которых оно попадает
+    if (is_closed) {
+        AcquireReportResultCache()->ObserveCloseTime(trade.close_time);
+    }
+
+    // Закрытая сделка изменена или добавлена задним числом - итоги завершенного дня
+    // в хранилище устарели. У измененной сделки мог смениться и день закрытия, поэтому
+    // после изменения сбрасываются все дни масок группы
+    const bool is_closed_update = is_closed && record_type == EV_RECORD_UPDATE;
+    const bool is_past_close    = is_closed && trade.close_time < CurrentDayStart();
+
+    const std::shared_ptr<IncrementalReportState> report_state = AcquireIncrementalState();
+    if (!report_state->IsEnabled() && !is_closed_update && !is_past_close) {
+        return;
+    }
+
+    try {
+        const std::shared_ptr<ReferenceCache> shared_cache = AcquireReferenceCache();
+        AccountCache                          account_cache(server, shared_cache.get());
+        const AccountRecord&                  account = account_cache.Get(trade.login);
+
+        if (is_closed_update || is_past_close) {
+            std::optional<time_t> close_day;
+            if (!is_closed_update) {
+                close_day = utils::CalculateDayStart(trade.close_time);
+            }
+
+            AcquireDayAggregateStore()->Invalidate(account.group, close_day);
+            ScheduleSnapshotWrite(true);
+        }
+
+        if (!report_state->IsEnabled()) {
+            return;
+        }
+
+        // Группа счета может отсутствовать в индексе: сделка учитывается без конвертации,
+        // как и в пакетном расчете
+        const std::shared_ptr<const GroupIndex> group_index = GetGroupIndex(*shared_cache, server);
+        const GroupInfo*                        group       = group_index->Find(account.group);
+
+        switch (record_type) {
+            case EV_RECORD_ADD:
+            case EV_RECORD_RESTORE:
+            case EV_RECORD_ACTIVATE_TRADE:
+            case EV_RECORD_CLOSE_TRADE:
+                break;
+            case EV_RECORD_UPDATE:
+            case EV_RECORD_DELETE:
+            case EV_RECORD_ARCHIVE:
+                // Закрытая сделка изменена задним числом - итоги дня пересчитываются пакетно
+                if (is_closed) {
+                    report_state->Invalidate(account.group);
+                    return;
+                }
+                if (record_type != EV_RECORD_UPDATE) {
+                    report_state->RemoveOpen(account.group, trade.order);
+                    return;
+                }
+                break;
+        }
+
+        StateTrade state_trade;
+        state_trade.order       = trade.order;
+        state_trade.login       = trade.login;
+        state_trade.cmd         = trade.cmd;
+        state_trade.volume      = trade.volume;
+        state_trade.close_time  = trade.close_time;
+        state_trade.open_price  = trade.open_price;
+        state_trade.close_price = trade.close_price;
+        state_trade.storage     = trade.storage;
+        state_trade.profit      = trade.profit;
+        state_trade.symbol      = trade.symbol;
+
+        // Нужен один курс: таблица курсов загрузила бы buy/sell для всех валют
+        if (group != nullptr) {
+            const double multiplier =
+                group->currency_id == USD_CURRENCY_ID
+                    ? 1.0
+                    : RateTable::Lookup(server, shared_cache.get(), group->currency, trade.cmd);
+
+            state_trade.usd_profit   = trade.profit * multiplier;
+            state_trade.is_converted = true;
+        }
+
+        if (is_closed) {
+            report_state->ApplyClose(account.group, state_trade);
+        } else {
+            report_state->ApplyOpen(account.group, state_trade);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
+    }
+}
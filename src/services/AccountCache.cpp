@@ -0,0 +1,85 @@
+#include "AccountCache.h"
+
+#include "utils/Utils.h"
+
+void AccountCache::Preload(const GroupIndex& group_index, const std::string& group_mask) {
+    std::vector<AccountRecord> accounts;
+
+    for (const auto& group : group_index.Groups()) {
+        if (!utils::MatchGroupMask(group_mask, group.name)) {
+            continue;
+        }
+
+        // Группа уже загружена недавно - аккаунты будут взяты из кэша плагина
+        if (_shared_cache != nullptr && _shared_cache->PreloadedGroups().Get(group.name).value) {
+            continue;
+        }
+
+        accounts.clear();
+        ++_group_calls;
+
+        try {
+            _server->GetAccountsByGroup(group.name, &accounts);
+        } catch (const std::exception& e) {
+            std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
+            continue;
+        }
+
+        _accounts.reserve(_accounts.size() + accounts.size());
+        for (auto& account : accounts) {
+            const int  login  = account.login;
+            const auto record = std::make_shared<const AccountRecord>(std::move(account));
+
+            _accounts.try_emplace(login, record);
+
+            if (_shared_cache != nullptr) {
+                _shared_cache->Accounts().Put(login, record);
+            }
+        }
+
+        if (_shared_cache != nullptr) {
+            _shared_cache->PreloadedGroups().Put(group.name, true);
+        }
+    }
+}
+
+const AccountRecord& AccountCache::Get(int login) {
+    auto it = _accounts.find(login);
+    if (it != _accounts.end()) {
+        return *it->second;
+    }
+
+    if (_shared_cache != nullptr) {
+        auto cached = _shared_cache->Accounts().Get(login);
+        if (cached.value) {
+            return *_accounts.emplace(login, std::move(cached.value)).first->second;
+        }
+    }
+
+    // Промах кэшируется в рамках отчета, чтобы логин не запрашивался повторно. В кэш плагина
+    // попадает только полученный аккаунт: пустая запись после сбоя сервера исказила бы
+    // группу логина во всех отчетах на время жизни записи
+    AccountRecord account;
+    bool          is_fetched = false;
+    ++_login_calls;
+
+    try {
+        _server->GetAccountByLogin(login, &account);
+        is_fetched = true;
+    } catch (const std::exception& e) {
+        std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
+    }
+
+    const auto record = std::make_shared<const AccountRecord>(std::move(account));
+
+    if (_shared_cache != nullptr && is_fetched) {
+        _shared_cache->Accounts().Put(login, record);
+    }
+
+    return *_accounts.emplace(login, record).first->second;
+}
+
+std::shared_ptr<const AccountRecord> AccountCache::GetShared(int login) {
+    Get(login);
+    return _accounts.at(login);
+}
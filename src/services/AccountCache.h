@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Structures.h"
+#include "services/GroupIndex.h"
+#include "services/ReferenceCache.h"
+
+// Кэш аккаунтов в рамках одного отчета: каждый логин запрашивается у сервера не более одного раза
+class AccountCache {
+public:
+    explicit AccountCache(CServerInterface* server, ReferenceCache* shared_cache = nullptr)
+        : _server(server), _shared_cache(shared_cache) {}
+
+    // Пакетная загрузка аккаунтов всех групп, подходящих под маску
+    void Preload(const GroupIndex& group_index, const std::string& group_mask);
+
+    // Аккаунт по логину; при промахе - кэш плагина, затем одиночный запрос к серверу
+    const AccountRecord& Get(int login);
+
+    // То же, но с владением записью - для данных, переживающих отчет
+    std::shared_ptr<const AccountRecord> GetShared(int login);
+
+    [[nodiscard]] size_t Size() const { return _accounts.size(); }
+
+    // Количество запросов к серверу: пакетных по группам и одиночных по логину
+    [[nodiscard]] size_t GroupCalls() const { return _group_calls; }
+
+    [[nodiscard]] size_t LoginCalls() const { return _login_calls; }
+
+private:
+    CServerInterface*                                             _server;
+    ReferenceCache*                                               _shared_cache;
+    std::unordered_map<int, std::shared_ptr<const AccountRecord>> _accounts;
+    size_t                                                        _group_calls = 0;
+    size_t                                                        _login_calls = 0;
+};
@@ -0,0 +1,110 @@
+#include "DayAggregateStore.h"
+
+#include "utils/Utils.h"
+
+std::optional<DailyTradesAggregate> DayAggregateStore::Find(const std::string& group_mask,
+                                                            time_t             day_start) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const auto mask_it = _masks.find(group_mask);
+    if (mask_it == _masks.end()) {
+        return std::nullopt;
+    }
+
+    _lru.splice(_lru.begin(), _lru, mask_it->second.lru_position);
+
+    const auto day_it = mask_it->second.days.find(day_start);
+    if (day_it == mask_it->second.days.end()) {
+        return std::nullopt;
+    }
+
+    return day_it->second;
+}
+
+uint64_t DayAggregateStore::Generation() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _generation;
+}
+
+void DayAggregateStore::Put(const std::string&          group_mask,
+                            time_t                      day_start,
+                            const DailyTradesAggregate& aggregate,
+                            uint64_t                    generation) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (generation != _generation) {
+        return;
+    }
+
+    auto mask_it = _masks.find(group_mask);
+    if (mask_it == _masks.end()) {
+        while (!_lru.empty() && _masks.size() >= _max_masks) {
+            _masks.erase(_lru.back());
+            _lru.pop_back();
+        }
+
+        _lru.push_front(group_mask);
+        mask_it = _masks.emplace(group_mask, MaskDays{{}, _lru.begin()}).first;
+    } else {
+        _lru.splice(_lru.begin(), _lru, mask_it->second.lru_position);
+    }
+
+    auto& days      = mask_it->second.days;
+    days[day_start] = aggregate;
+
+    // Самые старые дни вытесняются первыми
+    while (days.size() > _max_days_per_mask) {
+        days.erase(days.begin());
+    }
+}
+
+void DayAggregateStore::Invalidate(const std::string& group_name, std::optional<time_t> day_start) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    ++_generation;
+
+    for (auto mask_it = _masks.begin(); mask_it != _masks.end();) {
+        if (!group_name.empty() && !utils::MatchGroupMask(mask_it->first, group_name)) {
+            ++mask_it;
+            continue;
+        }
+
+        if (day_start) {
+            mask_it->second.days.erase(*day_start);
+            ++mask_it;
+            continue;
+        }
+
+        _lru.erase(mask_it->second.lru_position);
+        mask_it = _masks.erase(mask_it);
+    }
+}
+
+void DayAggregateStore::Clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _masks.clear();
+    _lru.clear();
+}
+
+void DayAggregateStore::ForEach(
+    const std::function<void(const std::string&          group_mask,
+                             time_t                      day_start,
+                             const DailyTradesAggregate& aggregate)>& visitor) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto it = _lru.rbegin(); it != _lru.rend(); ++it) {
+        for (const auto& [day_start, aggregate] : _masks.at(*it).days) {
+            visitor(*it, day_start, aggregate);
+        }
+    }
+}
+
+size_t DayAggregateStore::Size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    size_t size = 0;
+    for (const auto& [group_mask, mask_days] : _masks) {
+        size += mask_days.days.size();
+    }
+    return size;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "structures/PluginStructures.h"
+
+// Хранилище итогов завершенных дней по маске групп: закрытые дни не пересчитываются, пока их
+// сделки не изменены задним числом (Invalidate)
+class DayAggregateStore {
+public:
+    explicit DayAggregateStore(size_t max_masks = 256, size_t max_days_per_mask = 62)
+        : _max_masks(max_masks), _max_days_per_mask(max_days_per_mask) {}
+
+    [[nodiscard]] std::optional<DailyTradesAggregate> Find(const std::string& group_mask,
+                                                           time_t             day_start);
+
+    // Поколение увеличивается при каждом Invalidate. Итоги, посчитанные по выборке, начатой
+    // в другом поколении, могли не застать изменение сделки - Put их пропускает
+    [[nodiscard]] uint64_t Generation() const;
+
+    void Put(const std::string&          group_mask,
+             time_t                      day_start,
+             const DailyTradesAggregate& aggregate,
+             uint64_t                    generation);
+
+    // Итоги всех масок, под которые попадает группа (неизвестная группа - все маски):
+    // день day_start или, если день не задан, все дни маски
+    void Invalidate(const std::string& group_name, std::optional<time_t> day_start);
+
+    void Clear();
+
+    // Обход итогов от давно использованных масок к недавним (порядок для восстановления LRU)
+    void ForEach(const std::function<void(const std::string&          group_mask,
+                                          time_t                      day_start,
+                                          const DailyTradesAggregate& aggregate)>& visitor) const;
+
+    [[nodiscard]] size_t Size() const;
+
+private:
+    struct MaskDays {
+        std::map<time_t, DailyTradesAggregate> days;
+        std::list<std::string>::iterator       lru_position;
+    };
+
+    size_t                                    _max_masks;
+    size_t                                    _max_days_per_mask;
+    mutable std::mutex                        _mutex;
+    std::unordered_map<std::string, MaskDays> _masks;
+    std::list<std::string>                    _lru;
+    uint64_t                                  _generation = 0;
+};
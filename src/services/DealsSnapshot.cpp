@@ -0,0 +1,78 @@
+#include "DealsSnapshot.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "utils/Utils.h"
+
+DealsSnapshot::DealsSnapshot(const TradeColumns& trades,
+                             time_t              from,
+                             AccountCache&       account_cache,
+                             uint64_t            close_generation)
+    : _close_generation(close_generation) {
+    // Выборка может начинаться раньше выбранного дня - в снимок попадает только он
+    std::vector<size_t> rows;
+    rows.reserve(trades.Size());
+    for (size_t i = 0; i < trades.Size(); ++i) {
+        if (trades.close_time[i] >= from) {
+            rows.push_back(i);
+        }
+    }
+
+    std::sort(rows.begin(), rows.end(), [&trades](const size_t lhs, const size_t rhs) {
+        if (trades.close_time[lhs] != trades.close_time[rhs]) {
+            return trades.close_time[lhs] > trades.close_time[rhs];
+        }
+        return trades.order[lhs] > trades.order[rhs];
+    });
+
+    _trades = trades.Select(rows);
+
+    for (const int login : _trades.login) {
+        if (_accounts.find(login) == _accounts.end()) {
+            _accounts.emplace(login, account_cache.GetShared(login));
+        }
+    }
+}
+
+void DealsSnapshot::AddColumns(TableBuilder& builder, const FilterConfig& group_filter) {
+    FilterConfig search_filter;
+    search_filter.type = FilterType::Search;
+
+    FilterConfig date_time_filter;
+    date_time_filter.type = FilterType::DateTime;
+
+    builder.AddColumn({"close_time", "CLOSE_TIME", 1, date_time_filter});
+    builder.AddColumn({"order", "ORDER", 2, search_filter}, ColumnType::Int64);
+    builder.AddColumn({"login", "LOGIN", 3, search_filter}, ColumnType::Int64);
+    builder.AddColumn({"name", "NAME", 4, search_filter});
+    builder.AddColumn({"symbol", "SYMBOL", 5, search_filter});
+    builder.AddColumn({"group", "GROUP", 6, group_filter});
+    builder.AddColumn({"type", "TYPE", 7, std::nullopt});
+    builder.AddColumn({"volume", "VOLUME", 8, search_filter}, ColumnType::Double, 2);
+    builder.AddColumn({"close_price", "CLOSE_PRICE", 9, search_filter}, ColumnType::Double, 2);
+    builder.AddColumn({"storage", "SWAP", 10, search_filter}, ColumnType::Double, 2);
+    builder.AddColumn({"profit", "AMOUNT", 11, search_filter}, ColumnType::Double, 2);
+}
+
+void DealsSnapshot::WritePage(size_t page, size_t page_size, TableBuilder& builder) const {
+    const size_t begin = std::min(page * page_size, _trades.Size());
+    const size_t end   = std::min(begin + page_size, _trades.Size());
+
+    builder.ReserveRows(end - begin);
+    for (size_t row = begin; row < end; ++row) {
+        const AccountRecord& account = *_accounts.at(_trades.login[row]);
+
+        builder.AddString(utils::FormatTimestampToString(_trades.close_time[row]));
+        builder.AddInt(_trades.order[row]);
+        builder.AddInt(_trades.login[row]);
+        builder.AddString(account.name);
+        builder.AddString(_trades.symbols.Get(_trades.symbol_id[row]));
+        builder.AddString(account.group);
+        builder.AddString(_trades.cmd[row] == 0 ? "buy" : "sell");
+        builder.AddDouble(_trades.volume[row] / 100.0);
+        builder.AddDouble(_trades.close_price[row]);
+        builder.AddDouble(_trades.storage[row]);
+        builder.AddDouble(_trades.profit[row]);
+    }
+}
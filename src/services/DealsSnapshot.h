@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <unordered_map>
+
+#include "Structures.h"
+#include "sbxTableBuilder/SBXTableBuilder.hpp"
+#include "services/AccountCache.h"
+#include "structures/TradeColumns.h"
+
+// Снимок всех сделок выбранного дня для постраничной таблицы.
+// Строки скопированы в порядке сортировки (новые первыми), поэтому страница -
+// непрерывный диапазон строк и стоит O(размер страницы) без повторной выборки
+class DealsSnapshot {
+public:
+    // close_generation - поколение наблюдаемых закрытий (ReportResultCache::Generation),
+    // прочитанное до выборки trades
+    DealsSnapshot(const TradeColumns& trades,
+                  time_t              from,
+                  AccountCache&       account_cache,
+                  uint64_t            close_generation);
+
+    [[nodiscard]] size_t Size() const { return _trades.Size(); }
+
+    [[nodiscard]] uint64_t CloseGeneration() const { return _close_generation; }
+
+    // Время последнего закрытия в снимке (строки отсортированы от новых к старым)
+    [[nodiscard]] time_t LastCloseTime() const {
+        return _trades.Size() > 0 ? _trades.close_time.front() : 0;
+    }
+
+    // Колонки таблицы всех сделок; одинаковы для первой страницы и запросов страниц
+    static void AddColumns(TableBuilder& builder, const FilterConfig& group_filter);
+
+    // Строки страницы page (с нуля); страница за пределами снимка пуста
+    void WritePage(size_t page, size_t page_size, TableBuilder& builder) const;
+
+private:
+    TradeColumns                                                  _trades;
+    std::unordered_map<int, std::shared_ptr<const AccountRecord>> _accounts;
+    uint64_t                                                      _close_generation;
+};
@@ -0,0 +1,32 @@
+#include "GroupIndex.h"
+
+void GroupIndex::Build(const std::vector<GroupRecord>& groups) {
+    _groups.clear();
+    _group_ids.clear();
+    _currencies.assign({"USD"});
+    _currency_ids = {{"USD", USD_CURRENCY_ID}};
+
+    _groups.reserve(groups.size());
+    _group_ids.reserve(groups.size());
+
+    for (const auto& group : groups) {
+        const auto [group_it, inserted] =
+            _group_ids.try_emplace(group.group, static_cast<uint32_t>(_groups.size()));
+        if (!inserted) {
+            continue;
+        }
+
+        const auto [currency_it, is_new_currency] =
+            _currency_ids.try_emplace(group.currency, static_cast<uint32_t>(_currencies.size()));
+        if (is_new_currency) {
+            _currencies.push_back(group.currency);
+        }
+
+        _groups.push_back({group.group, group.currency, currency_it->second});
+    }
+}
+
+const GroupInfo* GroupIndex::Find(const std::string& group_name) const {
+    const auto it = _group_ids.find(group_name);
+    return it == _group_ids.end() ? nullptr : &_groups[it->second];
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Structures.h"
+
+// Идентификатор валюты USD в индексе групп (конвертация не требуется)
+inline constexpr uint32_t USD_CURRENCY_ID = 0;
+
+// Компактная запись группы для горячих циклов отчета
+struct GroupInfo {
+    std::string name;
+    std::string currency;
+    uint32_t    currency_id = USD_CURRENCY_ID;
+};
+
+// Индекс групп по имени: O(1) поиск вместо линейного прохода по groups_vector
+class GroupIndex {
+public:
+    GroupIndex() = default;
+    explicit GroupIndex(const std::vector<GroupRecord>& groups) { Build(groups); }
+
+    void Build(const std::vector<GroupRecord>& groups);
+
+    [[nodiscard]] const GroupInfo* Find(const std::string& group_name) const;
+
+    [[nodiscard]] const std::vector<GroupInfo>& Groups() const { return _groups; }
+
+    // Валюты групп, индекс в векторе - currency_id (USD всегда первый)
+    [[nodiscard]] const std::vector<std::string>& Currencies() const { return _currencies; }
+
+private:
+    std::vector<GroupInfo>                    _groups;
+    std::unordered_map<std::string, uint32_t> _group_ids;
+    std::vector<std::string>                  _currencies{"USD"};
+    std::unordered_map<std::string, uint32_t> _currency_ids{{"USD", USD_CURRENCY_ID}};
+};
@@ -0,0 +1,398 @@
+#include "IncrementalReportState.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "utils/Utils.h"
+
+namespace {
+    // При равной прибыли выше стоит сделка, закрытая раньше, - как у TopKSelector,
+    // который при равных ключах предпочитает меньшую строку упорядоченной по времени выборки
+    bool IsEarlier(const StateTrade& a, const StateTrade& b) {
+        if (a.close_time != b.close_time) {
+            return a.close_time < b.close_time;
+        }
+        return a.order < b.order;
+    }
+
+    bool IsMoreProfitable(const StateTrade& a, const StateTrade& b) {
+        return a.profit != b.profit ? a.profit > b.profit : IsEarlier(a, b);
+    }
+
+    bool IsMoreLosing(const StateTrade& a, const StateTrade& b) {
+        return a.profit != b.profit ? a.profit < b.profit : IsEarlier(a, b);
+    }
+
+    // Вставка в отсортированный список из не более чем count сделок
+    template <typename Better>
+    void
+    PushTop(std::vector<StateTrade>& top, const StateTrade& trade, size_t count, Better better) {
+        if (count == 0 || (top.size() == count && !better(trade, top.back()))) {
+            return;
+        }
+
+        top.insert(std::upper_bound(top.begin(), top.end(), trade, better), trade);
+        if (top.size() > count) {
+            top.pop_back();
+        }
+    }
+
+    void AddAggregate(DailyTradesAggregate& aggregate, const StateTrade& trade) {
+        if (trade.profit > 0) {
+            aggregate.profit_count += 1;
+        } else {
+            aggregate.loss_count += 1;
+        }
+
+        if (!trade.is_converted) {
+            return;
+        }
+
+        if (trade.usd_profit > 0) {
+            aggregate.profit += trade.usd_profit;
+        } else {
+            aggregate.loss += trade.usd_profit;
+        }
+
+        aggregate.total += trade.usd_profit;
+    }
+
+    void AddAggregate(DailyTradesAggregate& aggregate, const DailyTradesAggregate& other) {
+        aggregate.profit += other.profit;
+        aggregate.loss += other.loss;
+        aggregate.total += other.total;
+        aggregate.profit_count += other.profit_count;
+        aggregate.loss_count += other.loss_count;
+    }
+} // namespace
+
+IncrementalStateConfig IncrementalStateConfig::FromEnvironment() {
+    IncrementalStateConfig config;
+    config.is_enabled = utils::GetEnvSize("DAILY_TRADES_INCREMENTAL_STATE", 0) != 0;
+    config.top_count  = utils::GetEnvSize("DAILY_TRADES_INCREMENTAL_TOP", config.top_count);
+    config.max_days   = utils::GetEnvSize("DAILY_TRADES_INCREMENTAL_MAX_DAYS", config.max_days);
+    return config;
+}
+
+bool IncrementalReportState::IsLive(const GroupIndex&  group_index,
+                                    const std::string& group_mask,
+                                    time_t             window_from) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (const GroupInfo& group : group_index.Groups()) {
+        if (!utils::MatchGroupMask(group_mask, group.name)) {
+            continue;
+        }
+
+        const auto it = _groups.find(group.name);
+        if (it == _groups.end() || !it->second.is_live || it->second.covered_from > window_from) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t IncrementalReportState::BeginSeed(const std::string& group_mask) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const uint64_t seed_id = _next_seed_id++;
+    _seeds.push_back({seed_id, group_mask, {}});
+    return seed_id;
+}
+
+void IncrementalReportState::CancelSeed(uint64_t seed_id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::erase_if(_seeds, [seed_id](const SeedSession& seed) { return seed.id == seed_id; });
+}
+
+void IncrementalReportState::Seed(uint64_t            seed_id,
+                                  const GroupIndex&   group_index,
+                                  const std::string&  group_mask,
+                                  time_t              window_from,
+                                  const TradeColumns& close_trades,
+                                  const TradeColumns& open_trades,
+                                  AccountCache&       account_cache) {
+    // Состояние собирается вне блокировки, чтобы не задерживать обработку событий
+    std::unordered_map<std::string, GroupState> seeded;
+    for (const GroupInfo& group : group_index.Groups()) {
+        if (utils::MatchGroupMask(group_mask, group.name)) {
+            GroupState& state  = seeded[group.name];
+            state.is_live      = true;
+            state.covered_from = window_from;
+        }
+    }
+
+    // Группа счета может отсутствовать в индексе - ее сделки тоже входят в отчет по маске
+    const auto find_state = [&](int login) -> GroupState* {
+        const std::string& group = account_cache.Get(login).group;
+
+        const auto it = seeded.find(group);
+        if (it != seeded.end()) {
+            return &it->second;
+        }
+        if (!utils::MatchGroupMask(group_mask, group)) {
+            return nullptr;
+        }
+
+        GroupState& state  = seeded[group];
+        state.is_live      = true;
+        state.covered_from = window_from;
+        return &state;
+    };
+
+    for (size_t i = 0; i < close_trades.Size(); ++i) {
+        if (GroupState* state = find_state(close_trades.login[i])) {
+            AddClosed(*state, MakeTrade(close_trades, i));
+        }
+    }
+
+    for (size_t i = 0; i < open_trades.Size(); ++i) {
+        if (GroupState* state = find_state(open_trades.login[i])) {
+            state->open_positions[open_trades.order[i]] = MakeTrade(open_trades, i);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::vector<SeedEvent> events;
+    const auto it = std::find_if(_seeds.begin(), _seeds.end(), [seed_id](const SeedSession& seed) {
+        return seed.id == seed_id;
+    });
+    if (it != _seeds.end()) {
+        events = std::move(it->events);
+        _seeds.erase(it);
+    }
+
+    // Закрытия из событий, которые выборка уже застала, - обычно их нет или единицы
+    std::unordered_set<int> seeded_closes;
+    for (const SeedEvent& event : events) {
+        if (event.type == EventType::Close) {
+            seeded_closes.insert(event.trade.order);
+        }
+    }
+    if (!seeded_closes.empty()) {
+        std::unordered_set<int> fetched_closes;
+        for (const int order : close_trades.order) {
+            if (seeded_closes.count(order) != 0) {
+                fetched_closes.insert(order);
+            }
+        }
+        seeded_closes = std::move(fetched_closes);
+    }
+
+    for (auto& [name, state] : seeded) {
+        _groups[name] = std::move(state);
+    }
+
+    // Состояние и события атомарны относительно новых событий: они ждут этой блокировки
+    for (const SeedEvent& event : events) {
+        Apply(event.type,
+              event.group,
+              event.trade,
+              event.type == EventType::Close && seeded_closes.count(event.trade.order) != 0);
+    }
+}
+
+void IncrementalReportState::ApplyClose(const std::string& group, const StateTrade& trade) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Record(EventType::Close, group, trade);
+    Apply(EventType::Close, group, trade, false);
+}
+
+void IncrementalReportState::ApplyOpen(const std::string& group, const StateTrade& trade) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Record(EventType::Open, group, trade);
+    Apply(EventType::Open, group, trade, false);
+}
+
+void IncrementalReportState::RemoveOpen(const std::string& group, int order) {
+    StateTrade trade;
+    trade.order = order;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Record(EventType::RemoveOpen, group, trade);
+    Apply(EventType::RemoveOpen, group, trade, false);
+}
+
+void IncrementalReportState::Invalidate(const std::string& group) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Record(EventType::Invalidate, group, StateTrade{});
+    Apply(EventType::Invalidate, group, StateTrade{}, false);
+}
+
+void IncrementalReportState::InvalidateMask(const std::string& group_mask) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto it = _groups.begin(); it != _groups.end();) {
+        if (utils::MatchGroupMask(group_mask, it->first)) {
+            it = _groups.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void IncrementalReportState::Collect(const std::string&                      group_mask,
+                                     time_t                                  window_from,
+                                     time_t                                  from,
+                                     time_t                                  to,
+                                     std::map<time_t, DailyTradesAggregate>& daily_aggregates,
+                                     TradeColumns&                           close_candidates,
+                                     TradeColumns&                           open_positions) const {
+    const time_t window_day = utils::CalculateDayStart(window_from);
+    const time_t from_day   = utils::CalculateDayStart(from);
+
+    std::vector<StateTrade> candidates;
+    std::vector<StateTrade> positions;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (const auto& [name, state] : _groups) {
+            if (!utils::MatchGroupMask(group_mask, name)) {
+                continue;
+            }
+
+            for (auto day = state.days.lower_bound(window_day);
+                 day != state.days.end() && day->first <= to;
+                 ++day) {
+                AddAggregate(daily_aggregates[day->first], day->second.aggregate);
+
+                if (day->first < from_day) {
+                    continue;
+                }
+
+                // Сделка может попасть в оба списка дня - в кандидаты она идет один раз
+                std::unordered_set<int> orders;
+                for (const auto* top : {&day->second.top_profit, &day->second.top_loss}) {
+                    for (const StateTrade& trade : *top) {
+                        if (trade.close_time >= from && trade.close_time <= to &&
+                            orders.insert(trade.order).second) {
+                            candidates.push_back(trade);
+                        }
+                    }
+                }
+            }
+
+            for (const auto& [order, trade] : state.open_positions) {
+                positions.push_back(trade);
+            }
+        }
+    }
+
+    // Порядок строк как у выборки сервера - по времени, чтобы совпадал выбор при равной прибыли
+    std::sort(candidates.begin(), candidates.end(), IsEarlier);
+    std::sort(positions.begin(), positions.end(), [](const StateTrade& a, const StateTrade& b) {
+        return a.order < b.order;
+    });
+
+    close_candidates.Reserve(candidates.size());
+    for (const StateTrade& trade : candidates) {
+        Append(close_candidates, trade);
+    }
+
+    open_positions.Reserve(positions.size());
+    for (const StateTrade& trade : positions) {
+        Append(open_positions, trade);
+    }
+}
+
+void IncrementalReportState::Clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _groups.clear();
+    _seeds.clear();
+}
+
+void IncrementalReportState::Record(EventType          type,
+                                    const std::string& group,
+                                    const StateTrade&  trade) {
+    for (SeedSession& seed : _seeds) {
+        if (utils::MatchGroupMask(seed.group_mask, group)) {
+            seed.events.push_back({type, group, trade});
+        }
+    }
+}
+
+void IncrementalReportState::Apply(EventType          type,
+                                   const std::string& group,
+                                   const StateTrade&  trade,
+                                   bool               is_seeded_close) {
+    const auto it = _groups.find(group);
+    if (it == _groups.end()) {
+        return;
+    }
+
+    GroupState& state = it->second;
+
+    switch (type) {
+        case EventType::Close:
+            if (!state.is_live) {
+                return;
+            }
+            state.open_positions.erase(trade.order);
+            if (!is_seeded_close) {
+                AddClosed(state, trade);
+            }
+            break;
+        case EventType::Open:
+            if (state.is_live) {
+                state.open_positions[trade.order] = trade;
+            }
+            break;
+        case EventType::RemoveOpen:
+            state.open_positions.erase(trade.order);
+            break;
+        case EventType::Invalidate:
+            _groups.erase(it);
+            break;
+    }
+}
+
+void IncrementalReportState::AddClosed(GroupState& state, const StateTrade& trade) const {
+    if (trade.close_time < state.covered_from) {
+        return;
+    }
+
+    DayState& day = state.days[utils::CalculateDayStart(trade.close_time)];
+    AddAggregate(day.aggregate, trade);
+    PushTop(day.top_profit, trade, _config.top_count, IsMoreProfitable);
+    PushTop(day.top_loss, trade, _config.top_count, IsMoreLosing);
+
+    // Старые дни вытесняются, покрытие группы сдвигается вслед за ними
+    while (state.days.size() > std::max<size_t>(_config.max_days, 1)) {
+        state.days.erase(state.days.begin());
+        state.covered_from = state.days.begin()->first;
+    }
+}
+
+void IncrementalReportState::Append(TradeColumns& trades, const StateTrade& trade) {
+    trades.order.push_back(trade.order);
+    trades.login.push_back(trade.login);
+    trades.cmd.push_back(static_cast<int8_t>(trade.cmd));
+    trades.volume.push_back(trade.volume);
+    trades.close_time.push_back(trade.close_time);
+    trades.profit.push_back(trade.profit);
+    trades.storage.push_back(trade.storage);
+    trades.open_price.push_back(trade.open_price);
+    trades.close_price.push_back(trade.close_price);
+    trades.symbol_id.push_back(trades.symbols.Intern(trade.symbol));
+    trades.usd_profit.push_back(trade.usd_profit);
+    trades.is_converted.push_back(trade.is_converted ? 1 : 0);
+}
+
+StateTrade IncrementalReportState::MakeTrade(const TradeColumns& trades, size_t row) {
+    StateTrade trade;
+    trade.order        = trades.order[row];
+    trade.login        = trades.login[row];
+    trade.cmd          = trades.cmd[row];
+    trade.volume       = trades.volume[row];
+    trade.close_time   = trades.close_time[row];
+    trade.open_price   = trades.open_price[row];
+    trade.close_price  = trades.close_price[row];
+    trade.storage      = trades.storage[row];
+    trade.profit       = trades.profit[row];
+    trade.usd_profit   = trades.usd_profit[row];
+    trade.is_converted = trades.is_converted[row] != 0;
+    trade.symbol       = trades.symbols.Get(trades.symbol_id[row]);
+    return trade;
+}
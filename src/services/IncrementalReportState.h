@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "services/AccountCache.h"
+#include "services/GroupIndex.h"
+#include "structures/PluginStructures.h"
+#include "structures/TradeColumns.h"
+
+// Сделка в резидентном состоянии отчета: только поля, нужные секциям отчета
+struct StateTrade {
+    int         order        = 0;
+    int         login        = 0;
+    int         cmd          = 0;
+    int         volume       = 0;
+    time_t      close_time   = 0;
+    double      open_price   = 0.0;
+    double      close_price  = 0.0;
+    double      storage      = 0.0;
+    double      profit       = 0.0;
+    double      usd_profit   = 0.0;
+    bool        is_converted = false;
+    std::string symbol;
+};
+
+// Настройки резидентного состояния (переопределяются переменными окружения)
+struct IncrementalStateConfig {
+    // Состояние ведется, только если сервер доставляет события сделок в OnTradeEvent
+    bool   is_enabled = false;
+    size_t top_count  = 10;
+    size_t max_days   = 62;
+
+    static IncrementalStateConfig FromEnvironment();
+};
+
+// Резидентное состояние отчета по группам: итоги дней, лучшие/худшие закрытые сделки
+// каждого дня и открытые позиции. События сделок применяются за O(top_count),
+// отчет по маске собирается из состояния групп без выборки сделок с сервера.
+// Пакетный расчет заполняет состояние (Seed) и служит проверкой и восстановлением
+class IncrementalReportState {
+public:
+    explicit IncrementalReportState(
+        const IncrementalStateConfig& config = IncrementalStateConfig::FromEnvironment())
+        : _config(config) {}
+
+    [[nodiscard]] bool IsEnabled() const { return _config.is_enabled; }
+
+    [[nodiscard]] size_t TopCount() const { return _config.top_count; }
+
+    // Все группы маски заполнены, не помечены к пересчету и покрывают дни с window_from
+    [[nodiscard]] bool
+    IsLive(const GroupIndex& group_index, const std::string& group_mask, time_t window_from) const;
+
+    // Начало заполнения групп маски - вызывается до выборки сделок с сервера. До Seed
+    // события этих групп дополнительно запоминаются: выборка могла их не застать
+    [[nodiscard]] uint64_t BeginSeed(const std::string& group_mask);
+
+    // Состояние групп маски по результату пакетного расчета, покрывающего дни с window_from.
+    // Запомненные с BeginSeed события применяются поверх; закрытия, уже попавшие в выборку,
+    // пропускаются
+    void Seed(uint64_t            seed_id,
+              const GroupIndex&   group_index,
+              const std::string&  group_mask,
+              time_t              window_from,
+              const TradeColumns& close_trades,
+              const TradeColumns& open_trades,
+              AccountCache&       account_cache);
+
+    // Заполнение не состоялось (ошибка выборки); после Seed ничего не делает
+    void CancelSeed(uint64_t seed_id);
+
+    // События сделок живых групп; события остальных групп пропускаются до заполнения,
+    // а события заполняемых групп применяются при Seed
+    void ApplyClose(const std::string& group, const StateTrade& trade);
+
+    void ApplyOpen(const std::string& group, const StateTrade& trade);
+
+    void RemoveOpen(const std::string& group, int order);
+
+    // Изменение уже закрытой сделки не применяется инкрементально - группа пересчитывается
+    void Invalidate(const std::string& group);
+
+    // Все группы маски, например после расхождения с пакетным расчетом
+    void InvalidateMask(const std::string& group_mask);
+
+    // Вход секций отчета: итоги дней [window_from, to], кандидаты в лучшие/худшие сделки
+    // периода [from, to] и все открытые позиции групп маски (включая группы счетов,
+    // отсутствующие в индексе)
+    void Collect(const std::string&                      group_mask,
+                 time_t                                  window_from,
+                 time_t                                  from,
+                 time_t                                  to,
+                 std::map<time_t, DailyTradesAggregate>& daily_aggregates,
+                 TradeColumns&                           close_candidates,
+                 TradeColumns&                           open_positions) const;
+
+    void Clear();
+
+private:
+    struct DayState {
+        DailyTradesAggregate    aggregate;
+        std::vector<StateTrade> top_profit; // по убыванию прибыли
+        std::vector<StateTrade> top_loss;   // по возрастанию прибыли
+    };
+
+    struct GroupState {
+        bool                                is_live      = false;
+        time_t                              covered_from = 0;
+        std::map<time_t, DayState>          days;
+        std::unordered_map<int, StateTrade> open_positions;
+    };
+
+    enum class EventType { Close, Open, RemoveOpen, Invalidate };
+
+    struct SeedEvent {
+        EventType   type;
+        std::string group;
+        StateTrade  trade;
+    };
+
+    // События групп маски между BeginSeed и Seed в порядке поступления
+    struct SeedSession {
+        uint64_t               id;
+        std::string            group_mask;
+        std::vector<SeedEvent> events;
+    };
+
+    // Вызываются под _mutex. Закрытие, уже учтенное выборкой заполнения
+    // (is_seeded_close), только снимает открытую позицию
+    void Record(EventType type, const std::string& group, const StateTrade& trade);
+
+    void Apply(EventType          type,
+               const std::string& group,
+               const StateTrade&  trade,
+               bool               is_seeded_close);
+
+    void AddClosed(GroupState& state, const StateTrade& trade) const;
+
+    static void Append(TradeColumns& trades, const StateTrade& trade);
+
+    static StateTrade MakeTrade(const TradeColumns& trades, size_t row);
+
+    IncrementalStateConfig                      _config;
+    mutable std::mutex                          _mutex;
+    std::unordered_map<std::string, GroupState> _groups;
+    std::vector<SeedSession>                    _seeds;
+    uint64_t                                    _next_seed_id = 1;
+};
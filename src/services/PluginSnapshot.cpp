@@ -0,0 +1,289 @@
+#include "PluginSnapshot.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/Utils.h"
+
+namespace {
+    constexpr char     SNAPSHOT_MAGIC[8] = {'D', 'T', 'R', 'S', 'N', 'A', 'P', '\0'};
+    constexpr uint32_t BYTE_ORDER_MARK   = 0x01020304;
+
+    // Заголовок фиксированного размера; данные пишутся в порядке байт записавшей машины,
+    // поэтому снимок с другим порядком байт отбрасывается по BYTE_ORDER_MARK
+    struct SnapshotHeader {
+        char     magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint64_t payload_size;
+        uint64_t checksum;
+        int64_t  written_at;
+    };
+
+    static_assert(sizeof(SnapshotHeader) == 40, "snapshot header layout must not change");
+
+    // FNV-1a: достаточно для обнаружения поврежденного или недописанного файла
+    uint64_t Checksum(const char* data, size_t size) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    class SnapshotWriter {
+    public:
+        template <typename T>
+        void Put(T value) {
+            _data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void PutString(const std::string& value) {
+            Put(static_cast<uint32_t>(value.size()));
+            _data.append(value);
+        }
+
+        [[nodiscard]] const std::string& Data() const { return _data; }
+
+    private:
+        std::string _data;
+    };
+
+    // Чтение с проверкой границ: выход за конец данных - поврежденный снимок
+    class SnapshotReader {
+    public:
+        SnapshotReader(const char* data, size_t size) : _data(data), _size(size) {}
+
+        template <typename T>
+        T Get() {
+            T value;
+            std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        std::string GetString() {
+            const auto size = Get<uint32_t>();
+            return {Take(size), size};
+        }
+
+        // Количество записей не может превышать остаток данных - защита от огромных reserve
+        uint32_t GetCount(size_t min_record_size) {
+            const auto count = Get<uint32_t>();
+            if (count > (_size - _position) / min_record_size) {
+                throw std::runtime_error("snapshot record count is out of range");
+            }
+            return count;
+        }
+
+        [[nodiscard]] bool IsEnd() const { return _position == _size; }
+
+    private:
+        const char* Take(size_t size) {
+            if (size > _size - _position) {
+                throw std::runtime_error("snapshot is truncated");
+            }
+            const char* data = _data + _position;
+            _position += size;
+            return data;
+        }
+
+        const char* _data;
+        size_t      _size;
+        size_t      _position = 0;
+    };
+
+    // Файл, отображенный в память только для чтения
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path) {
+            _descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (_descriptor < 0) {
+                return;
+            }
+
+            struct stat file_stat {};
+            if (fstat(_descriptor, &file_stat) != 0 || file_stat.st_size <= 0) {
+                return;
+            }
+
+            void* data = mmap(nullptr,
+                              static_cast<size_t>(file_stat.st_size),
+                              PROT_READ,
+                              MAP_PRIVATE,
+                              _descriptor,
+                              0);
+            if (data != MAP_FAILED) {
+                _data = static_cast<const char*>(data);
+                _size = static_cast<size_t>(file_stat.st_size);
+            }
+        }
+
+        ~MappedFile() {
+            if (_data != nullptr) {
+                munmap(const_cast<char*>(_data), _size);
+            }
+            if (_descriptor >= 0) {
+                close(_descriptor);
+            }
+        }
+
+        MappedFile(const MappedFile&)            = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] bool IsOpen() const { return _descriptor >= 0; }
+
+        [[nodiscard]] const char* Data() const { return _data; }
+
+        [[nodiscard]] size_t Size() const { return _size; }
+
+    private:
+        int         _descriptor = -1;
+        const char* _data       = nullptr;
+        size_t      _size       = 0;
+    };
+
+    // write может записать только часть данных или прерваться сигналом
+    bool WriteAll(int descriptor, const char* data, size_t size) {
+        while (size > 0) {
+            const ssize_t written = write(descriptor, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+} // namespace
+
+PluginSnapshotConfig PluginSnapshotConfig::FromEnvironment() {
+    PluginSnapshotConfig config;
+    if (const char* path = std::getenv("DAILY_TRADES_SNAPSHOT_PATH")) {
+        config.path = path;
+    }
+    config.interval = utils::GetEnvSeconds("DAILY_TRADES_SNAPSHOT_INTERVAL", config.interval);
+    return config;
+}
+
+void PluginSnapshot::Write(const std::string& path, const DayAggregateStore& aggregate_store) {
+    SnapshotWriter writer;
+
+    // Итоги завершенных дней: маска, день, итог
+    std::vector<std::pair<std::string, std::pair<time_t, DailyTradesAggregate>>> aggregates;
+    aggregate_store.ForEach(
+        [&](const std::string& group_mask, time_t day_start, const DailyTradesAggregate& day) {
+            aggregates.emplace_back(group_mask, std::make_pair(day_start, day));
+        });
+
+    writer.Put(static_cast<uint32_t>(aggregates.size()));
+    for (const auto& [group_mask, day] : aggregates) {
+        writer.PutString(group_mask);
+        writer.Put(static_cast<int64_t>(day.first));
+        writer.Put(day.second.profit);
+        writer.Put(day.second.loss);
+        writer.Put(day.second.total);
+        writer.Put(static_cast<int32_t>(day.second.profit_count));
+        writer.Put(static_cast<int32_t>(day.second.loss_count));
+    }
+
+    const std::string& payload = writer.Data();
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version      = VERSION;
+    header.byte_order   = BYTE_ORDER_MARK;
+    header.payload_size = payload.size();
+    header.checksum     = Checksum(payload.data(), payload.size());
+    header.written_at   = static_cast<int64_t>(std::time(nullptr));
+
+    const std::string temporary_path = path + ".part";
+
+    // Файл, оставшийся от прерванной записи, удаляется: права задаются только при создании
+    unlink(temporary_path.c_str());
+
+    const int descriptor =
+        open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (descriptor < 0) {
+        throw std::runtime_error("cannot create snapshot " + temporary_path + ": " +
+                                 std::strerror(errno));
+    }
+
+    const bool is_written =
+        WriteAll(descriptor, reinterpret_cast<const char*>(&header), sizeof(header)) &&
+        WriteAll(descriptor, payload.data(), payload.size()) && fsync(descriptor) == 0;
+
+    if (close(descriptor) != 0 || !is_written ||
+        std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+        std::remove(temporary_path.c_str());
+        throw std::runtime_error("cannot write snapshot " + path + ": " + std::strerror(errno));
+    }
+}
+
+bool PluginSnapshot::Load(const std::string& path, DayAggregateStore& aggregate_store) {
+    const MappedFile file(path);
+    if (!file.IsOpen()) {
+        return false;
+    }
+
+    SnapshotHeader header{};
+    if (file.Size() < sizeof(header)) {
+        throw std::runtime_error("snapshot " + path + " is truncated");
+    }
+    std::memcpy(&header, file.Data(), sizeof(header));
+
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.byte_order != BYTE_ORDER_MARK) {
+        throw std::runtime_error("snapshot " + path + " has an unknown format");
+    }
+    if (header.version != VERSION) {
+        throw std::runtime_error("snapshot " + path + " has schema version " +
+                                 std::to_string(header.version) + ", expected " +
+                                 std::to_string(VERSION));
+    }
+
+    const char* payload = file.Data() + sizeof(header);
+    if (header.payload_size != file.Size() - sizeof(header) ||
+        header.checksum != Checksum(payload, header.payload_size)) {
+        throw std::runtime_error("snapshot " + path + " checksum mismatch");
+    }
+
+    SnapshotReader reader(payload, header.payload_size);
+
+    // Сначала разбирается весь файл, хранилище заполняется только после успешного разбора
+    std::vector<std::pair<std::string, std::pair<time_t, DailyTradesAggregate>>> aggregates;
+    aggregates.resize(reader.GetCount(sizeof(uint32_t) + 40));
+    for (auto& [group_mask, day] : aggregates) {
+        group_mask              = reader.GetString();
+        day.first               = static_cast<time_t>(reader.Get<int64_t>());
+        day.second.profit       = reader.Get<double>();
+        day.second.loss         = reader.Get<double>();
+        day.second.total        = reader.Get<double>();
+        day.second.profit_count = reader.Get<int32_t>();
+        day.second.loss_count   = reader.Get<int32_t>();
+    }
+
+    if (!reader.IsEnd()) {
+        throw std::runtime_error("snapshot " + path + " has trailing data");
+    }
+
+    const uint64_t generation = aggregate_store.Generation();
+    for (const auto& [group_mask, day] : aggregates) {
+        aggregate_store.Put(group_mask, day.first, day.second, generation);
+    }
+
+    return true;
+}
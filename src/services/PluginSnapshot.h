@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "services/DayAggregateStore.h"
+
+// Настройки снимка состояния на диске (переопределяются переменными окружения)
+struct PluginSnapshotConfig {
+    // Пустой путь - снимок не ведется
+    std::string          path;
+    std::chrono::seconds interval{300};
+
+    static PluginSnapshotConfig FromEnvironment();
+};
+
+// Снимок итогов завершенных дней на диске: после перезапуска сервера первый отчет берет их
+// из файла вместо полной выборки двухнедельного окна. Справочные данные (группы, курсы,
+// аккаунты) в файл не пишутся: их время жизни короче типичного перезапуска, и они
+// загружаются с сервера заново.
+// Файл - заголовок (сигнатура, версия схемы, порядок байт, размер и контрольная сумма
+// данных, время записи) и итоги дней. Файл другой версии или поврежденный файл
+// пропускается целиком: отчеты строятся с нуля, как без снимка
+class PluginSnapshot {
+public:
+    static constexpr uint32_t VERSION = 2;
+
+    // Запись во временный файл (доступ только владельцу) с переименованием: читатель не
+    // увидит частичный снимок
+    static void Write(const std::string& path, const DayAggregateStore& aggregate_store);
+
+    // Файл отображается в память только для чтения. false - файла нет; поврежденный файл -
+    // исключение. Хранилище заполняется только после проверки всего файла
+    static bool Load(const std::string& path, DayAggregateStore& aggregate_store);
+};
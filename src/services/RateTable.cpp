@@ -0,0 +1,54 @@
+#include "RateTable.h"
+
+RateTable::RateTable(CServerInterface*               server,
+                     const std::vector<std::string>& currencies,
+                     ReferenceCache*                 shared_cache)
+    : _server(server), _shared_cache(shared_cache), _currencies(currencies),
+      _rates(currencies.size() * CMD_SLOTS, std::numeric_limits<double>::quiet_NaN()) {
+    // Курсы buy/sell нужны почти всегда - загружаем их сразу для всех валют
+    for (uint32_t currency_id = 0; currency_id < _currencies.size(); ++currency_id) {
+        if (currency_id == USD_CURRENCY_ID) {
+            continue;
+        }
+
+        for (const int cmd : {OP_BUY, OP_SELL}) {
+            try {
+                _rates[currency_id * CMD_SLOTS + cmd] = Fetch(currency_id, cmd);
+            } catch (const std::exception& e) {
+                std::cerr << "[DailyTradesReportInterface]: " << e.what() << std::endl;
+            }
+        }
+    }
+}
+
+double RateTable::Fetch(uint32_t currency_id, int cmd) {
+    return Lookup(_server, _shared_cache, _currencies[currency_id], cmd, &_server_calls);
+}
+
+double RateTable::Lookup(CServerInterface*  server,
+                         ReferenceCache*    shared_cache,
+                         const std::string& currency,
+                         int                cmd,
+                         size_t*            server_calls) {
+    RateKey key{currency, cmd};
+
+    if (shared_cache != nullptr) {
+        const auto cached = shared_cache->Rates().Get(key);
+        if (cached.value) {
+            return *cached.value;
+        }
+    }
+
+    double multiplier = 0.0;
+
+    if (server_calls != nullptr) {
+        ++*server_calls;
+    }
+    server->CalculateConvertRateByCurrency(key.currency, "USD", cmd, &multiplier);
+
+    if (shared_cache != nullptr) {
+        shared_cache->Rates().Put(key, multiplier);
+    }
+
+    return multiplier;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "Structures.h"
+#include "services/GroupIndex.h"
+#include "services/ReferenceCache.h"
+
+// Таблица курсов конвертации в USD на время одного отчета: (валюта, cmd) -> множитель
+class RateTable {
+public:
+    // Количество запоминаемых типов операций (OP_BUY ... OP_SELL_STOP_LIMIT)
+    static constexpr int CMD_SLOTS = OP_SELL_STOP_LIMIT + 1;
+
+    RateTable(CServerInterface*               server,
+              const std::vector<std::string>& currencies,
+              ReferenceCache*                 shared_cache = nullptr);
+
+    // Множитель конвертации в USD; при первом обращении к ячейке - кэш плагина или сервер
+    double Get(uint32_t currency_id, int cmd) {
+        if (currency_id == USD_CURRENCY_ID) {
+            return 1.0;
+        }
+
+        ++_lookups;
+
+        if (cmd < 0 || cmd >= CMD_SLOTS) {
+            return Fetch(currency_id, cmd);
+        }
+
+        double& rate = _rates[currency_id * CMD_SLOTS + cmd];
+        if (std::isnan(rate)) { // курс еще не загружен
+            rate = Fetch(currency_id, cmd);
+        }
+
+        return rate;
+    }
+
+    // Один курс без таблицы - для единичных сделок (события): кэш плагина, при промахе -
+    // сервер. Запрос к серверу учитывается в server_calls, если он передан
+    static double Lookup(CServerInterface*  server,
+                         ReferenceCache*    shared_cache,
+                         const std::string& currency,
+                         int                cmd,
+                         size_t*            server_calls = nullptr);
+
+    [[nodiscard]] size_t ServerCalls() const { return _server_calls; }
+
+    // Сколько запросов к серверу сэкономлено по сравнению с запросом на каждую сделку
+    [[nodiscard]] size_t SavedCalls() const {
+        return _lookups > _server_calls ? _lookups - _server_calls : 0;
+    }
+
+private:
+    double Fetch(uint32_t currency_id, int cmd);
+
+    CServerInterface*        _server;
+    ReferenceCache*          _shared_cache;
+    std::vector<std::string> _currencies;
+    std::vector<double>      _rates;
+    size_t                   _lookups      = 0;
+    size_t                   _server_calls = 0;
+};
@@ -0,0 +1,45 @@
+#include "ReferenceCache.h"
+
+#include "utils/Utils.h"
+
+namespace {
+    std::string FormatCacheStats(const char* name, const CacheStats& stats) {
+        return std::string(name) + " hits=" + std::to_string(stats.hits) +
+               " misses=" + std::to_string(stats.misses) +
+               " expired=" + std::to_string(stats.expirations) +
+               " evicted=" + std::to_string(stats.evictions) +
+               " size=" + std::to_string(stats.size);
+    }
+} // namespace
+
+ReferenceCacheConfig ReferenceCacheConfig::FromEnvironment() {
+    ReferenceCacheConfig config;
+    config.accounts_ttl =
+        utils::GetEnvSeconds("DAILY_TRADES_CACHE_ACCOUNTS_TTL", config.accounts_ttl);
+    config.groups_ttl   = utils::GetEnvSeconds("DAILY_TRADES_CACHE_GROUPS_TTL", config.groups_ttl);
+    config.rates_ttl    = utils::GetEnvSeconds("DAILY_TRADES_CACHE_RATES_TTL", config.rates_ttl);
+    config.max_accounts = utils::GetEnvSize("DAILY_TRADES_CACHE_MAX_ACCOUNTS", config.max_accounts);
+    config.max_groups   = utils::GetEnvSize("DAILY_TRADES_CACHE_MAX_GROUPS", config.max_groups);
+    config.max_rates    = utils::GetEnvSize("DAILY_TRADES_CACHE_MAX_RATES", config.max_rates);
+    return config;
+}
+
+ReferenceCache::ReferenceCache(const ReferenceCacheConfig& config)
+    : _accounts(config.accounts_ttl, config.max_accounts),
+      _preloaded_groups(config.accounts_ttl, config.max_groups),
+      _groups(config.groups_ttl, 1),
+      _rates(config.rates_ttl, config.max_rates) {}
+
+void ReferenceCache::Clear() {
+    _accounts.Clear();
+    _preloaded_groups.Clear();
+    _groups.Clear();
+    _rates.Clear();
+}
+
+std::string ReferenceCache::FormatStats() const {
+    return FormatCacheStats("accounts", _accounts.Stats()) + "; " +
+           FormatCacheStats("preloaded_groups", _preloaded_groups.Stats()) + "; " +
+           FormatCacheStats("groups", _groups.Stats()) + "; " +
+           FormatCacheStats("rates", _rates.Stats());
+}
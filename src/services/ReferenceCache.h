@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "Structures.h"
+#include "services/GroupIndex.h"
+#include "services/TtlCache.h"
+
+// Настройки кэша справочных данных (переопределяются переменными окружения)
+struct ReferenceCacheConfig {
+    std::chrono::seconds accounts_ttl{300};
+    std::chrono::seconds groups_ttl{60};
+    std::chrono::seconds rates_ttl{60};
+    size_t               max_accounts = 500000;
+    size_t               max_groups   = 4096;
+    size_t               max_rates    = 4096;
+
+    static ReferenceCacheConfig FromEnvironment();
+};
+
+// Ключ курса конвертации в USD
+struct RateKey {
+    std::string currency;
+    int         cmd = 0;
+
+    bool operator==(const RateKey& other) const {
+        return cmd == other.cmd && currency == other.currency;
+    }
+};
+
+struct RateKeyHash {
+    size_t operator()(const RateKey& key) const {
+        return std::hash<std::string>()(key.currency) * 31 + static_cast<size_t>(key.cmd);
+    }
+};
+
+// Кэш справочных данных на время жизни плагина: аккаунты, группы, курсы
+class ReferenceCache {
+public:
+    explicit ReferenceCache(
+        const ReferenceCacheConfig& config = ReferenceCacheConfig::FromEnvironment());
+
+    TtlCache<int, AccountRecord>& Accounts() { return _accounts; }
+
+    // Отметки о пакетной загрузке аккаунтов группы
+    TtlCache<std::string, bool>& PreloadedGroups() { return _preloaded_groups; }
+
+    TtlCache<int, GroupIndex>& Groups() { return _groups; }
+
+    TtlCache<RateKey, double, RateKeyHash>& Rates() { return _rates; }
+
+    void Clear();
+
+    [[nodiscard]] std::string FormatStats() const;
+
+private:
+    TtlCache<int, AccountRecord>           _accounts;
+    TtlCache<std::string, bool>            _preloaded_groups;
+    TtlCache<int, GroupIndex>              _groups;
+    TtlCache<RateKey, double, RateKeyHash> _rates;
+};
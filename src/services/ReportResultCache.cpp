@@ -0,0 +1,162 @@
+#include "ReportResultCache.h"
+
+#include <algorithm>
+
+#include "utils/Utils.h"
+
+ReportResultCacheConfig ReportResultCacheConfig::FromEnvironment() {
+    ReportResultCacheConfig config;
+    config.ttl       = utils::GetEnvSeconds("DAILY_TRADES_RESULT_CACHE_TTL", config.ttl);
+    config.max_bytes = utils::GetEnvSize("DAILY_TRADES_RESULT_CACHE_MAX_BYTES", config.max_bytes);
+    return config;
+}
+
+ReportResultCache::ReportResultCache(const ReportResultCacheConfig& config) : _config(config) {}
+
+std::shared_ptr<const rapidjson::Document> ReportResultCache::Find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        ++_stats.misses;
+        return nullptr;
+    }
+
+    const Entry& entry = it->second;
+
+    if (Clock::now() >= entry.expires_at) {
+        ++_stats.expirations;
+        ++_stats.misses;
+        Erase(it);
+        return nullptr;
+    }
+
+    ++_stats.hits;
+    _lru.splice(_lru.begin(), _lru, entry.lru_position);
+    return entry.document;
+}
+
+uint64_t ReportResultCache::Generation() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _generation;
+}
+
+void ReportResultCache::Put(const std::string&      key,
+                            const rapidjson::Value& response,
+                            time_t                  from,
+                            time_t                  to,
+                            time_t                  watermark,
+                            uint64_t                generation) {
+    if (_config.max_bytes == 0 || _config.ttl.count() <= 0) {
+        return;
+    }
+
+    // Копия строк тоже уходит в аллокатор документа: запись не зависит от ответа
+    auto document = std::make_shared<rapidjson::Document>();
+    document->CopyFrom(response, document->GetAllocator(), true);
+
+    const size_t bytes = document->GetAllocator().Capacity() + key.size() + sizeof(Entry);
+    if (bytes > _config.max_bytes) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Пока отчет строился, в его окне закрылась сделка, которой в выборке может не быть
+    if (HasCloseSinceLocked(generation, from, to, watermark)) {
+        return;
+    }
+
+    const auto it = _entries.find(key);
+    if (it != _entries.end()) {
+        Erase(it);
+    }
+
+    while (!_lru.empty() && _bytes + bytes > _config.max_bytes) {
+        Erase(_entries.find(_lru.back()));
+        ++_stats.evictions;
+    }
+
+    _lru.push_front(key);
+    _entries.emplace(key,
+                     Entry{std::move(document),
+                           bytes,
+                           from,
+                           to,
+                           watermark,
+                           Clock::now() + _config.ttl,
+                           _lru.begin()});
+    _bytes += bytes;
+}
+
+void ReportResultCache::ObserveCloseTime(time_t close_time) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    ++_generation;
+    _recent_closes.push_back(close_time);
+    if (_recent_closes.size() > kMaxRecentCloses) {
+        _recent_closes.pop_front();
+    }
+
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        const Entry& entry = it->second;
+        const bool is_stale =
+            entry.watermark < close_time && entry.from <= close_time && close_time <= entry.to;
+
+        if (is_stale) {
+            ++_stats.expirations;
+            Erase(it++);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool ReportResultCache::HasCloseSince(uint64_t generation,
+                                      time_t   from,
+                                      time_t   to,
+                                      time_t   watermark) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return HasCloseSinceLocked(generation, from, to, watermark);
+}
+
+void ReportResultCache::Clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _lru.clear();
+    _bytes = 0;
+}
+
+CacheStats ReportResultCache::Stats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    CacheStats                  stats = _stats;
+    stats.size                        = _entries.size();
+    return stats;
+}
+
+size_t ReportResultCache::Bytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _bytes;
+}
+
+bool ReportResultCache::HasCloseSinceLocked(uint64_t generation,
+                                            time_t   from,
+                                            time_t   to,
+                                            time_t   watermark) const {
+    const uint64_t missed = _generation - generation;
+    if (missed > _recent_closes.size()) {
+        return true;
+    }
+
+    return std::any_of(_recent_closes.end() - static_cast<std::ptrdiff_t>(missed),
+                       _recent_closes.end(),
+                       [from, to, watermark](const time_t close_time) {
+                           return watermark < close_time && from <= close_time && close_time <= to;
+                       });
+}
+
+void ReportResultCache::Erase(std::unordered_map<std::string, Entry>::iterator it) {
+    _bytes -= it->second.bytes;
+    _lru.erase(it->second.lru_position);
+    _entries.erase(it);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "services/TtlCache.h"
+#include <rapidjson/document.h>
+
+// Настройки кэша готовых отчетов (переопределяются переменными окружения)
+struct ReportResultCacheConfig {
+    std::chrono::seconds ttl{15};
+    size_t               max_bytes = 64 * 1024 * 1024;
+
+    static ReportResultCacheConfig FromEnvironment();
+};
+
+// Кэш готовых ответов по нормализованному запросу: повторное открытие отчета
+// копирует сохраненный rapidjson-документ вместо полного перестроения.
+// Ограничен временем жизни записей и суммарным объемом памяти (LRU)
+class ReportResultCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ReportResultCache(
+        const ReportResultCacheConfig& config = ReportResultCacheConfig::FromEnvironment());
+
+    // nullptr, если записи нет или истек TTL
+    [[nodiscard]] std::shared_ptr<const rapidjson::Document> Find(const std::string& key);
+
+    // Поколение увеличивается с каждым наблюдаемым закрытием. Его читают до выборки сделок,
+    // чтобы потом проверить закрытия, пришедшие во время построения (HasCloseSince)
+    [[nodiscard]] uint64_t Generation() const;
+
+    // watermark - время последней закрытой сделки, вошедшей в ответ; generation - поколение
+    // на начало выборки. Ответ, в окно которого с тех пор попала более новая сделка, не
+    // сохраняется
+    void Put(const std::string&      key,
+             const rapidjson::Value& response,
+             time_t                  from,
+             time_t                  to,
+             time_t                  watermark,
+             uint64_t                generation);
+
+    // Закрытая сделка с этим временем видна серверу: записи, окно которых ее покрывает
+    // и которые построены по более ранним сделкам, удаляются сразу
+    void ObserveCloseTime(time_t close_time);
+
+    // Было ли после поколения generation закрытие в окне [from, to] новее watermark.
+    // Если журнал закрытий уже не помнит это поколение, ответ консервативный - true
+    [[nodiscard]] bool HasCloseSince(uint64_t generation,
+                                     time_t   from,
+                                     time_t   to,
+                                     time_t   watermark) const;
+
+    void Clear();
+
+    [[nodiscard]] CacheStats Stats() const;
+
+    [[nodiscard]] size_t Bytes() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const rapidjson::Document> document;
+        size_t                                     bytes;
+        time_t                                     from;
+        time_t                                     to;
+        time_t                                     watermark;
+        Clock::time_point                          expires_at;
+        std::list<std::string>::iterator           lru_position;
+    };
+
+    void Erase(std::unordered_map<std::string, Entry>::iterator it);
+
+    [[nodiscard]] bool HasCloseSinceLocked(uint64_t generation,
+                                           time_t   from,
+                                           time_t   to,
+                                           time_t   watermark) const;
+
+    // Последние наблюдаемые закрытия; закрытие с номером _generation - последнее в журнале
+    static constexpr size_t kMaxRecentCloses = 4096;
+
+    ReportResultCacheConfig                _config;
+    mutable std::mutex                     _mutex;
+    std::unordered_map<std::string, Entry> _entries;
+    std::list<std::string>                 _lru;
+    std::deque<time_t>                     _recent_closes;
+    size_t                                 _bytes      = 0;
+    uint64_t                               _generation = 0;
+    CacheStats                             _stats;
+};
@@ -0,0 +1,50 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threads_count) {
+    _workers.reserve(threads_count);
+    for (size_t i = 0; i < threads_count; ++i) {
+        _workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _is_stopping = true;
+    }
+    _condition.notify_all();
+
+    for (auto& worker : _workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+size_t ThreadPool::DefaultThreadsCount() {
+    // Минимум 3 потока - по одному на каждый независимый запрос к серверу
+    const size_t hardware_threads = std::thread::hardware_concurrency();
+    return std::clamp<size_t>(hardware_threads, 3, 16);
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]() { return _is_stopping || !_tasks.empty(); });
+
+            if (_is_stopping && _tasks.empty()) {
+                return;
+            }
+
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+
+        task();
+    }
+}
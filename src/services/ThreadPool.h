@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Пул потоков плагина для параллельных запросов к серверу и вычислений отчета
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads_count = DefaultThreadsCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto Submit(F&& task) -> std::future<std::invoke_result_t<F>> {
+        using Result = std::invoke_result_t<F>;
+
+        auto packaged_task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged_task->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.emplace([packaged_task]() { (*packaged_task)(); });
+        }
+        _condition.notify_one();
+
+        return future;
+    }
+
+    [[nodiscard]] size_t Size() const { return _workers.size(); }
+
+    static size_t DefaultThreadsCount();
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread>          _workers;
+    std::queue<std::function<void()>> _tasks;
+    std::mutex                        _mutex;
+    std::condition_variable           _condition;
+    bool                              _is_stopping = false;
+};
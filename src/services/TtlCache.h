@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// Статистика попаданий кэша
+struct CacheStats {
+    uint64_t hits        = 0;
+    uint64_t misses      = 0;
+    uint64_t expirations = 0;
+    uint64_t evictions   = 0;
+    size_t   size        = 0;
+};
+
+// Потокобезопасный LRU-кэш с временем жизни записей и ограничением по количеству
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class TtlCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Значение вместе с поколением записи (увеличивается при каждой перезаписи ключа)
+    struct Lookup {
+        std::shared_ptr<const Value> value;
+        uint64_t                     generation = 0;
+    };
+
+    TtlCache(std::chrono::seconds ttl, size_t max_size) : _ttl(ttl), _max_size(max_size) {}
+
+    Lookup Get(const Key& key) {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const auto it = _entries.find(key);
+        if (it == _entries.end()) {
+            ++_stats.misses;
+            return {};
+        }
+
+        if (Clock::now() >= it->second.expires_at) {
+            ++_stats.expirations;
+            ++_stats.misses;
+            _lru.erase(it->second.lru_position);
+            _entries.erase(it);
+            return {};
+        }
+
+        ++_stats.hits;
+        _lru.splice(_lru.begin(), _lru, it->second.lru_position);
+        return {it->second.value, it->second.generation};
+    }
+
+    uint64_t Put(const Key& key, std::shared_ptr<const Value> value) {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const uint64_t generation = ++_generation;
+        const auto     expires_at = Clock::now() + _ttl;
+
+        const auto it = _entries.find(key);
+        if (it != _entries.end()) {
+            it->second.value      = std::move(value);
+            it->second.expires_at = expires_at;
+            it->second.generation = generation;
+            _lru.splice(_lru.begin(), _lru, it->second.lru_position);
+            return generation;
+        }
+
+        while (!_lru.empty() && _entries.size() >= _max_size) {
+            _entries.erase(_lru.back());
+            _lru.pop_back();
+            ++_stats.evictions;
+        }
+
+        if (_max_size == 0) {
+            return generation;
+        }
+
+        _lru.push_front(key);
+        _entries.emplace(key, Entry{std::move(value), expires_at, generation, _lru.begin()});
+        return generation;
+    }
+
+    uint64_t Put(const Key& key, Value value) {
+        return Put(key, std::make_shared<const Value>(std::move(value)));
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.clear();
+        _lru.clear();
+    }
+
+    [[nodiscard]] CacheStats Stats() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        CacheStats                  stats = _stats;
+        stats.size                        = _entries.size();
+        return stats;
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<const Value>      value;
+        Clock::time_point                 expires_at;
+        uint64_t                          generation;
+        typename std::list<Key>::iterator lru_position;
+    };
+
+    std::chrono::seconds                 _ttl;
+    size_t                               _max_size;
+    mutable std::mutex                   _mutex;
+    std::unordered_map<Key, Entry, Hash> _entries;
+    std::list<Key>                       _lru;
+    uint64_t                             _generation = 0;
+    CacheStats                           _stats;
+};
@@ -3,22 +3,19 @@
 #include <ctime>
 #include <string>
 
-struct UsdConvertedTrade {
-    time_t close_time;
-    double usd_profit;
+// Дневные итоги закрытых сделок для графиков PnL и количества сделок
+struct DailyTradesAggregate {
+    double profit       = 0.0;
+    double loss         = 0.0;
+    double total        = 0.0;
+    int    profit_count = 0;
+    int    loss_count   = 0;
 };
 
-struct PnlDataPoint {
-    std::string date;
-    int         profit;
-    int         loss;
-    int         total;
-};
-
-struct TradesCountDataPoint {
-    std::string date;
-    int         profit;
-    int         loss;
+// Суммарная прибыль и убыток (положительным числом) открытых позиций в USD
+struct OpenPositionsTotals {
+    double profit = 0.0;
+    double loss   = 0.0;
 };
 
 struct OpenPositionsPieDataPoint {
@@ -0,0 +1,69 @@
+#include "TradeColumns.h"
+
+uint32_t SymbolTable::Intern(const std::string& symbol) {
+    const auto [it, inserted] =
+        symbol_ids.try_emplace(symbol, static_cast<uint32_t>(symbols.size()));
+    if (inserted) {
+        symbols.push_back(symbol);
+    }
+    return it->second;
+}
+
+void TradeColumns::Reserve(size_t size) {
+    order.reserve(size);
+    login.reserve(size);
+    cmd.reserve(size);
+    volume.reserve(size);
+    close_time.reserve(size);
+    profit.reserve(size);
+    storage.reserve(size);
+    open_price.reserve(size);
+    close_price.reserve(size);
+    symbol_id.reserve(size);
+    usd_profit.reserve(size);
+    is_converted.reserve(size);
+}
+
+void TradeColumns::Ingest(std::vector<TradeRecord>&& trades) {
+    Reserve(Size() + trades.size());
+
+    for (const auto& trade : trades) {
+        order.push_back(trade.order);
+        login.push_back(trade.login);
+        cmd.push_back(static_cast<int8_t>(trade.cmd));
+        volume.push_back(trade.volume);
+        close_time.push_back(trade.close_time);
+        profit.push_back(trade.profit);
+        storage.push_back(trade.storage);
+        open_price.push_back(trade.open_price);
+        close_price.push_back(trade.close_price);
+        symbol_id.push_back(symbols.Intern(trade.symbol));
+        usd_profit.push_back(0.0);
+        is_converted.push_back(0);
+    }
+
+    std::vector<TradeRecord>().swap(trades);
+}
+
+TradeColumns TradeColumns::Select(const std::vector<size_t>& rows) const {
+    TradeColumns selected;
+    selected.Reserve(rows.size());
+    selected.symbols = symbols;
+
+    for (const size_t row : rows) {
+        selected.order.push_back(order[row]);
+        selected.login.push_back(login[row]);
+        selected.cmd.push_back(cmd[row]);
+        selected.volume.push_back(volume[row]);
+        selected.close_time.push_back(close_time[row]);
+        selected.profit.push_back(profit[row]);
+        selected.storage.push_back(storage[row]);
+        selected.open_price.push_back(open_price[row]);
+        selected.close_price.push_back(close_price[row]);
+        selected.symbol_id.push_back(symbol_id[row]);
+        selected.usd_profit.push_back(usd_profit[row]);
+        selected.is_converted.push_back(is_converted[row]);
+    }
+
+    return selected;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Structures.h"
+
+// Интернированные символы: каждая строка хранится один раз, сделки ссылаются на нее по индексу
+struct SymbolTable {
+    std::vector<std::string>                  symbols;
+    std::unordered_map<std::string, uint32_t> symbol_ids;
+
+    uint32_t Intern(const std::string& symbol);
+
+    [[nodiscard]] const std::string& Get(uint32_t symbol_id) const { return symbols[symbol_id]; }
+};
+
+// Колоночное (structure-of-arrays) представление сделок: только поля, нужные отчету
+struct TradeColumns {
+    std::vector<int>      order;
+    std::vector<int>      login;
+    std::vector<int8_t>   cmd;
+    std::vector<int>      volume;
+    std::vector<time_t>   close_time;
+    std::vector<double>   profit;
+    std::vector<double>   storage;
+    std::vector<double>   open_price;
+    std::vector<double>   close_price;
+    std::vector<uint32_t> symbol_id;
+
+    // Заполняются при конвертации в USD
+    std::vector<double>  usd_profit;
+    std::vector<uint8_t> is_converted;
+
+    SymbolTable symbols;
+
+    [[nodiscard]] size_t Size() const { return order.size(); }
+
+    void Reserve(size_t size);
+
+    // Проекция сделок в колонки; исходный вектор освобождается сразу после проекции
+    void Ingest(std::vector<TradeRecord>&& trades);
+
+    // Копия строк rows в заданном порядке (таблица символов копируется целиком)
+    [[nodiscard]] TradeColumns Select(const std::vector<size_t>& rows) const;
+};
@@ -0,0 +1,272 @@
+#include "Aggregation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+#include "SimdKernels.h"
+#include "Utils.h"
+#include "services/ThreadPool.h"
+
+namespace utils {
+    // Размер блока подобран так, чтобы колонки блока помещались в L1/L2
+    constexpr size_t AGGREGATION_BLOCK_SIZE = 4096;
+
+    // Диапазон строк с отдельным частичным результатом; не зависит от числа потоков
+    constexpr size_t AGGREGATION_CHUNK_SIZE = 16 * AGGREGATION_BLOCK_SIZE;
+
+    namespace {
+        void ConsumeRange(const TradeColumns&                     trades,
+                          const std::vector<SectionAccumulator*>& sections,
+                          size_t                                  begin,
+                          size_t                                  end) {
+            for (size_t block_begin = begin; block_begin < end;
+                 block_begin += AGGREGATION_BLOCK_SIZE) {
+                const size_t block_end = std::min(end, block_begin + AGGREGATION_BLOCK_SIZE);
+
+                for (SectionAccumulator* section : sections) {
+                    section->Consume(trades, block_begin, block_end);
+                }
+            }
+        }
+
+        // Очередь диапазонов прохода: потоки забирают следующий свободный диапазон,
+        // пока они не закончатся, поэтому медленный поток не задерживает остальных.
+        // Задача, взятая пулом после окончания диапазонов, обращается только к очереди
+        struct ChunkQueue {
+            explicit ChunkQueue(size_t chunks_count) : count(chunks_count) {}
+
+            std::atomic<size_t>     next{1};
+            const size_t            count;
+            std::mutex              mutex;
+            std::condition_variable done;
+            size_t                  completed = 0;
+            std::exception_ptr      error;
+        };
+    } // namespace
+
+    void DailyAggregateAccumulator::Add(DailyTradesAggregate& data_point,
+                                        const TradeColumns&   trades,
+                                        size_t                row) {
+        if (trades.profit[row] > 0) {
+            data_point.profit_count += 1;
+        } else {
+            data_point.loss_count += 1;
+        }
+
+        if (!trades.is_converted[row]) {
+            return;
+        }
+
+        const double usd_profit = trades.usd_profit[row];
+
+        if (usd_profit > 0) {
+            data_point.profit += usd_profit;
+        } else {
+            data_point.loss += usd_profit;
+        }
+
+        data_point.total += usd_profit;
+    }
+
+    void DailyAggregateAccumulator::Consume(const TradeColumns& trades, size_t begin, size_t end) {
+        // Серверы отдают сделки упорядоченными по времени, поэтому строки блока идут сериями
+        // одного дня: серия суммируется векторным ядром, короткие серии - скалярно
+        constexpr size_t MIN_KERNEL_RUN = 16;
+
+        for (size_t run_begin = begin; run_begin < end;) {
+            const size_t bucket  = _buckets.Index(trades.close_time[run_begin]);
+            size_t       run_end = run_begin + 1;
+
+            while (run_end < end && _buckets.Index(trades.close_time[run_end]) == bucket) {
+                ++run_end;
+            }
+
+            if (bucket == DayBucketer::NPOS) {
+                // Сделки вне окна отчета - редкий случай, считаем через календарь
+                for (size_t i = run_begin; i < run_end; ++i) {
+                    Add(_daily_data[CalculateDayStart(trades.close_time[i])], trades, i);
+                }
+            } else if (run_end - run_begin < MIN_KERNEL_RUN) {
+                for (size_t i = run_begin; i < run_end; ++i) {
+                    Add(_bucket_data[bucket], trades, i);
+                }
+            } else {
+                const size_t size = run_end - run_begin;
+                const auto   sums = simd::SumProfitLoss(
+                    &trades.usd_profit[run_begin], &trades.is_converted[run_begin], size);
+                const size_t profit_count = simd::CountPositive(&trades.profit[run_begin], size);
+
+                DailyTradesAggregate& data_point = _bucket_data[bucket];
+                data_point.profit += sums.profit;
+                data_point.loss += sums.loss;
+                data_point.total += sums.profit + sums.loss;
+                data_point.profit_count += static_cast<int>(profit_count);
+                data_point.loss_count += static_cast<int>(size - profit_count);
+            }
+
+            run_begin = run_end;
+        }
+    }
+
+    void DailyAggregateAccumulator::Add(DailyTradesAggregate&       data_point,
+                                        const DailyTradesAggregate& other) {
+        data_point.profit += other.profit;
+        data_point.loss += other.loss;
+        data_point.total += other.total;
+        data_point.profit_count += other.profit_count;
+        data_point.loss_count += other.loss_count;
+    }
+
+    std::unique_ptr<SectionAccumulator> DailyAggregateAccumulator::Fork() const {
+        return std::unique_ptr<DailyAggregateAccumulator>(new DailyAggregateAccumulator(_buckets));
+    }
+
+    void DailyAggregateAccumulator::Merge(const SectionAccumulator& partial) {
+        const auto& other = static_cast<const DailyAggregateAccumulator&>(partial);
+
+        for (size_t bucket = 0; bucket < _bucket_data.size(); ++bucket) {
+            Add(_bucket_data[bucket], other._bucket_data[bucket]);
+        }
+
+        for (const auto& [day_start, data_point] : other._partial_daily_data) {
+            Add(_daily_data[day_start], data_point);
+        }
+    }
+
+    void DailyAggregateAccumulator::Finish() {
+        for (size_t bucket = 0; bucket < _bucket_data.size(); ++bucket) {
+            const DailyTradesAggregate& bucket_data = _bucket_data[bucket];
+
+            if (bucket_data.profit_count == 0 && bucket_data.loss_count == 0) {
+                continue;
+            }
+
+            Add(_daily_data[_buckets.DayStart(bucket)], bucket_data);
+        }
+    }
+
+    void TopOrdersAccumulator::Consume(const TradeColumns& trades, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (trades.close_time[i] >= _min_close_time) {
+                _profit_selector.Push(trades.profit[i], i);
+                _loss_selector.Push(trades.profit[i], i);
+            }
+        }
+    }
+
+    void TopOrdersAccumulator::Finish() {
+        _top_profit = _profit_selector.SortedRows();
+        _top_loss   = _loss_selector.SortedRows();
+    }
+
+    std::unique_ptr<SectionAccumulator> TopOrdersAccumulator::Fork() const {
+        return std::make_unique<TopOrdersAccumulator>(_min_close_time, _count);
+    }
+
+    void TopOrdersAccumulator::Merge(const SectionAccumulator& partial) {
+        Merge(static_cast<const TopOrdersAccumulator&>(partial));
+    }
+
+    void TopOrdersAccumulator::Merge(const TopOrdersAccumulator& other) {
+        _profit_selector.Merge(other._profit_selector);
+        _loss_selector.Merge(other._loss_selector);
+    }
+
+    void OpenPositionsAccumulator::Consume(const TradeColumns& trades, size_t begin, size_t end) {
+        const size_t size = end - begin;
+        const auto   sums =
+            simd::SumProfitLoss(&trades.usd_profit[begin], &trades.is_converted[begin], size);
+
+        _totals.profit += sums.profit;
+        _totals.loss += -sums.loss; // убыток как положительное число
+    }
+
+    std::unique_ptr<SectionAccumulator> OpenPositionsAccumulator::Fork() const {
+        return std::make_unique<OpenPositionsAccumulator>();
+    }
+
+    void OpenPositionsAccumulator::Merge(const SectionAccumulator& partial) {
+        const auto& other = static_cast<const OpenPositionsAccumulator&>(partial);
+
+        _totals.profit += other._totals.profit;
+        _totals.loss += other._totals.loss;
+    }
+
+    void RunAggregation(const TradeColumns&                       trades,
+                        std::initializer_list<SectionAccumulator*> sections,
+                        ThreadPool*                                pool) {
+        const size_t                           size = trades.Size();
+        const std::vector<SectionAccumulator*> targets(sections);
+
+        const size_t chunks_count =
+            std::max<size_t>(1, (size + AGGREGATION_CHUNK_SIZE - 1) / AGGREGATION_CHUNK_SIZE);
+
+        // Первый диапазон накапливается прямо в секциях, остальные - в частичных результатах
+        std::vector<std::vector<std::unique_ptr<SectionAccumulator>>> partials(chunks_count);
+        const auto queue = std::make_shared<ChunkQueue>(chunks_count);
+
+        const auto consume_chunks = [&trades, &targets, &partials, size, queue]() {
+            for (size_t chunk = queue->next++; chunk < queue->count; chunk = queue->next++) {
+                try {
+                    std::vector<SectionAccumulator*> chunk_sections;
+                    chunk_sections.reserve(targets.size());
+
+                    for (const SectionAccumulator* section : targets) {
+                        partials[chunk].push_back(section->Fork());
+                        chunk_sections.push_back(partials[chunk].back().get());
+                    }
+
+                    ConsumeRange(trades,
+                                 chunk_sections,
+                                 chunk * AGGREGATION_CHUNK_SIZE,
+                                 std::min(size, (chunk + 1) * AGGREGATION_CHUNK_SIZE));
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(queue->mutex);
+                    if (!queue->error) {
+                        queue->error = std::current_exception();
+                    }
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(queue->mutex);
+                    ++queue->completed;
+                }
+                queue->done.notify_all();
+            }
+        };
+
+        // Вызывающий поток тоже разбирает диапазоны: проход не ждет занятых потоков пула
+        if (pool != nullptr) {
+            const size_t helpers_count = std::min(pool->Size(), chunks_count - 1);
+            for (size_t i = 0; i < helpers_count; ++i) {
+                pool->Submit(consume_chunks);
+            }
+        }
+
+        ConsumeRange(trades, targets, 0, std::min(size, AGGREGATION_CHUNK_SIZE));
+        consume_chunks();
+
+        {
+            std::unique_lock<std::mutex> lock(queue->mutex);
+            queue->done.wait(lock, [&queue]() { return queue->completed == queue->count - 1; });
+        }
+
+        if (queue->error) {
+            std::rethrow_exception(queue->error);
+        }
+
+        for (size_t chunk = 1; chunk < chunks_count; ++chunk) {
+            for (size_t i = 0; i < targets.size(); ++i) {
+                targets[i]->Merge(*partials[chunk][i]);
+            }
+            partials[chunk].clear();
+        }
+
+        for (SectionAccumulator* section : targets) {
+            section->Finish();
+        }
+    }
+} // namespace utils
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <ctime>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "structures/PluginStructures.h"
+#include "structures/TradeColumns.h"
+#include "utils/DayBucketer.h"
+#include "utils/TopKSelector.h"
+
+class ThreadPool;
+
+namespace utils {
+    // Частичные результаты разных потоков не должны делить строку кэша
+    constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // Секция отчета, накапливающая свои данные во время общего прохода по сделкам
+    class SectionAccumulator {
+    public:
+        virtual ~SectionAccumulator() = default;
+
+        // Обработка строк [begin, end) - блок уже находится в кэше процессора
+        virtual void Consume(const TradeColumns& trades, size_t begin, size_t end) = 0;
+
+        // Пустая секция с теми же параметрами для частичного результата диапазона строк
+        [[nodiscard]] virtual std::unique_ptr<SectionAccumulator> Fork() const = 0;
+
+        // Слияние частичного результата, полученного через Fork для следующего диапазона
+        virtual void Merge(const SectionAccumulator& partial) = 0;
+
+        // Вызывается один раз после прохода
+        virtual void Finish() {}
+    };
+
+    // Дневные итоги для графиков PnL и количества сделок в плоском массиве по номеру дня
+    class alignas(CACHE_LINE_SIZE) DailyAggregateAccumulator final : public SectionAccumulator {
+    public:
+        DailyAggregateAccumulator(std::map<time_t, DailyTradesAggregate>& daily_data,
+                                  const DayBucketer&                      buckets)
+            : _daily_data(daily_data), _buckets(buckets), _bucket_data(buckets.Size()) {}
+
+        void Consume(const TradeColumns& trades, size_t begin, size_t end) override;
+
+        [[nodiscard]] std::unique_ptr<SectionAccumulator> Fork() const override;
+
+        void Merge(const SectionAccumulator& partial) override;
+
+        void Finish() override;
+
+    private:
+        // Частичный результат: сделки вне окна копятся в собственном календаре
+        explicit DailyAggregateAccumulator(const DayBucketer& buckets)
+            : _daily_data(_partial_daily_data), _buckets(buckets), _bucket_data(buckets.Size()) {}
+
+        static void Add(DailyTradesAggregate& data_point, const TradeColumns& trades, size_t row);
+
+        static void Add(DailyTradesAggregate& data_point, const DailyTradesAggregate& other);
+
+        std::map<time_t, DailyTradesAggregate>  _partial_daily_data;
+        std::map<time_t, DailyTradesAggregate>& _daily_data;
+        const DayBucketer&                      _buckets;
+        std::vector<DailyTradesAggregate>       _bucket_data;
+    };
+
+    // Лучшие и худшие сделки по прибыли, начиная с min_close_time
+    class alignas(CACHE_LINE_SIZE) TopOrdersAccumulator final : public SectionAccumulator {
+    public:
+        explicit TopOrdersAccumulator(time_t min_close_time = 0, size_t count = 10)
+            : _min_close_time(min_close_time), _count(count), _profit_selector(count),
+              _loss_selector(count) {}
+
+        void Consume(const TradeColumns& trades, size_t begin, size_t end) override;
+
+        [[nodiscard]] std::unique_ptr<SectionAccumulator> Fork() const override;
+
+        void Merge(const SectionAccumulator& partial) override;
+
+        void Finish() override;
+
+        // Слияние с аккумулятором, обработавшим другой диапазон строк
+        void Merge(const TopOrdersAccumulator& other);
+
+        [[nodiscard]] const std::vector<size_t>& TopProfit() const { return _top_profit; }
+
+        [[nodiscard]] const std::vector<size_t>& TopLoss() const { return _top_loss; }
+
+    private:
+        time_t              _min_close_time;
+        size_t              _count;
+        TopProfitSelector   _profit_selector;
+        TopLossSelector     _loss_selector;
+        std::vector<size_t> _top_profit;
+        std::vector<size_t> _top_loss;
+    };
+
+    // Суммарная прибыль/убыток открытых позиций в USD
+    class alignas(CACHE_LINE_SIZE) OpenPositionsAccumulator final : public SectionAccumulator {
+    public:
+        void Consume(const TradeColumns& trades, size_t begin, size_t end) override;
+
+        [[nodiscard]] std::unique_ptr<SectionAccumulator> Fork() const override;
+
+        void Merge(const SectionAccumulator& partial) override;
+
+        [[nodiscard]] const OpenPositionsTotals& Totals() const { return _totals; }
+
+    private:
+        OpenPositionsTotals _totals;
+    };
+
+    // Один потоковый проход по сделкам блоками для всех переданных секций.
+    // Строки делятся на диапазоны фиксированного размера; при переданном пуле диапазоны
+    // разбираются его потоками и вызывающим потоком. Частичные результаты сливаются
+    // в порядке диапазонов, поэтому итог не зависит от числа потоков и совпадает
+    // с однопоточным проходом (pool == nullptr)
+    void RunAggregation(const TradeColumns&                       trades,
+                        std::initializer_list<SectionAccumulator*> sections,
+                        ThreadPool*                                pool = nullptr);
+} // namespace utils
@@ -0,0 +1,15 @@
+#include "DayBucketer.h"
+
+#include "Utils.h"
+
+namespace utils {
+    DayBucketer::DayBucketer(time_t from, time_t to) {
+        time_t day_start = CalculateDayStart(from);
+        _day_starts.push_back(day_start);
+
+        do {
+            day_start = CalculateNextDayStart(day_start);
+            _day_starts.push_back(day_start);
+        } while (day_start <= to);
+    }
+} // namespace utils
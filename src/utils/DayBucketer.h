@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <ctime>
+#include <vector>
+
+namespace utils {
+    // Разбиение окна отчета на локальные сутки. Начала суток (с учетом смены UTC-смещения)
+    // вычисляются один раз, после чего close_time переводится в номер дня без localtime_r.
+    class DayBucketer {
+    public:
+        static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+        DayBucketer(time_t from, time_t to);
+
+        // Номер дня для времени или NPOS, если время вне окна
+        [[nodiscard]] size_t Index(time_t time) const {
+            if (time < _day_starts.front() || time >= _day_starts.back()) {
+                return NPOS;
+            }
+
+            size_t index = static_cast<size_t>((time - _day_starts.front()) / SECONDS_PER_DAY);
+            if (index >= Size()) {
+                index = Size() - 1;
+            }
+
+            // Сутки перехода на летнее/зимнее время короче или длиннее - поправка не больше 1
+            while (time < _day_starts[index]) {
+                --index;
+            }
+            while (time >= _day_starts[index + 1]) {
+                ++index;
+            }
+
+            return index;
+        }
+
+        [[nodiscard]] size_t Size() const { return _day_starts.size() - 1; }
+
+        [[nodiscard]] time_t DayStart(size_t index) const { return _day_starts[index]; }
+
+    private:
+        static constexpr time_t SECONDS_PER_DAY = 24 * 60 * 60;
+
+        // Начала суток окна и начало следующих за последними суток
+        std::vector<time_t> _day_starts;
+    };
+} // namespace utils
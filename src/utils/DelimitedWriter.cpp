@@ -0,0 +1,201 @@
+#include "DelimitedWriter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <rapidjson/internal/dtoa.h>
+#include <rapidjson/internal/itoa.h>
+
+namespace utils {
+    namespace {
+        // Степени десяти для форматирования с фиксированным количеством знаков
+        constexpr int64_t POWERS_OF_TEN[] = {1,
+                                             10,
+                                             100,
+                                             1000,
+                                             10000,
+                                             100000,
+                                             1000000,
+                                             10000000,
+                                             100000000};
+
+        constexpr int MAX_FIXED_DIGITS = 8;
+
+        char* WriteTwoDigits(char* out, int value) {
+            *out++ = static_cast<char>('0' + value / 10);
+            *out++ = static_cast<char>('0' + value % 10);
+            return out;
+        }
+    } // namespace
+
+    DelimitedWriter::DelimitedWriter(const std::string& path, char delimiter)
+        : _file(std::fopen(path.c_str(), "wb")), _delimiter(delimiter),
+          _buffer(std::make_unique<char[]>(BUFFER_SIZE)) {}
+
+    DelimitedWriter::~DelimitedWriter() { Close(); }
+
+    void DelimitedWriter::Int(int64_t value) {
+        BeginField();
+        Reserve(MAX_FIELD_SIZE);
+
+        char* end = rapidjson::internal::i64toa(value, &_buffer[_size]);
+        _size     = end - _buffer.get();
+    }
+
+    void DelimitedWriter::Fixed(double value, int digits) {
+        BeginField();
+        Reserve(MAX_FIELD_SIZE);
+
+        digits              = std::clamp(digits, 0, MAX_FIXED_DIGITS);
+        const double scaled = std::round(value * static_cast<double>(POWERS_OF_TEN[digits]));
+        char*        out    = &_buffer[_size];
+
+        // Значения вне диапазона int64 (и не числа) - кратчайшая запись dtoa
+        if (!(std::fabs(scaled) < 9.0e18)) {
+            out   = rapidjson::internal::dtoa(value, out, digits);
+            _size = out - _buffer.get();
+            return;
+        }
+
+        auto units = static_cast<int64_t>(scaled);
+        if (units < 0) {
+            *out++ = '-';
+            units  = -units;
+        }
+
+        const auto integer_part = static_cast<uint64_t>(units / POWERS_OF_TEN[digits]);
+        out                     = rapidjson::internal::u64toa(integer_part, out);
+
+        if (digits > 0) {
+            *out++ = '.';
+
+            // Дробная часть с ведущими нулями
+            int64_t fraction = units % POWERS_OF_TEN[digits];
+            for (int i = digits - 1; i >= 0; --i) {
+                out[i] = static_cast<char>('0' + fraction % 10);
+                fraction /= 10;
+            }
+            out += digits;
+        }
+
+        _size = out - _buffer.get();
+    }
+
+    void DelimitedWriter::String(std::string_view value) {
+        BeginField();
+
+        if (_delimiter == '\t') {
+            // В TSV нет экранирования - разделители внутри значения заменяются пробелом
+            Reserve(value.size());
+            for (const char symbol : value) {
+                const bool is_separator = symbol == '\t' || symbol == '\n' || symbol == '\r';
+                _buffer[_size++]        = is_separator ? ' ' : symbol;
+            }
+            return;
+        }
+
+        const bool is_quoted = value.find_first_of(",\"\r\n") != std::string_view::npos;
+        if (!is_quoted) {
+            Reserve(value.size());
+            std::memcpy(&_buffer[_size], value.data(), value.size());
+            _size += value.size();
+            return;
+        }
+
+        // Кавычки внутри значения удваиваются
+        Reserve(value.size() * 2 + 2);
+        _buffer[_size++] = '"';
+        for (const char symbol : value) {
+            if (symbol == '"') {
+                _buffer[_size++] = '"';
+            }
+            _buffer[_size++] = symbol;
+        }
+        _buffer[_size++] = '"';
+    }
+
+    void DelimitedWriter::Timestamp(time_t value) {
+        BeginField();
+
+        if (value == 0) {
+            return;
+        }
+
+        std::tm tm{};
+        localtime_r(&value, &tm);
+
+        Reserve(MAX_FIELD_SIZE);
+        char* out = &_buffer[_size];
+
+        const int year = tm.tm_year + 1900;
+        out            = WriteTwoDigits(out, year / 100);
+        out            = WriteTwoDigits(out, year % 100);
+        *out++         = '.';
+        out            = WriteTwoDigits(out, tm.tm_mon + 1);
+        *out++         = '.';
+        out            = WriteTwoDigits(out, tm.tm_mday);
+        *out++         = ' ';
+        out            = WriteTwoDigits(out, tm.tm_hour);
+        *out++         = ':';
+        out            = WriteTwoDigits(out, tm.tm_min);
+        *out++         = ':';
+        out            = WriteTwoDigits(out, tm.tm_sec);
+
+        _size = out - _buffer.get();
+    }
+
+    void DelimitedWriter::EndRow() {
+        Reserve(1);
+        _buffer[_size++] = '\n';
+        _is_row_start    = true;
+        ++_rows;
+    }
+
+    bool DelimitedWriter::Close() {
+        if (_file == nullptr) {
+            return false;
+        }
+
+        Flush();
+
+        _is_failed = std::fclose(_file) != 0 || _is_failed;
+        _file      = nullptr;
+        return !_is_failed;
+    }
+
+    void DelimitedWriter::BeginField() {
+        if (!_is_row_start) {
+            Reserve(1);
+            _buffer[_size++] = _delimiter;
+        }
+        _is_row_start = false;
+    }
+
+    void DelimitedWriter::Reserve(size_t size) {
+        if (_size + size <= _capacity) {
+            return;
+        }
+
+        Flush();
+
+        // Значение длиннее буфера - буфер расширяется под него
+        if (size > _capacity) {
+            _buffer   = std::make_unique<char[]>(size);
+            _capacity = size;
+        }
+    }
+
+    void DelimitedWriter::Flush() {
+        if (_size == 0) {
+            return;
+        }
+
+        if (_file == nullptr || std::fwrite(_buffer.get(), 1, _size, _file) != _size) {
+            _is_failed = true;
+        }
+
+        _bytes += _size;
+        _size = 0;
+    }
+} // namespace utils
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace utils {
+    // Потоковая запись строк CSV/TSV в файл через собственный буфер: форматирование
+    // чисел и дат не выделяет память, на диск уходят блоки по BUFFER_SIZE байт
+    class DelimitedWriter {
+    public:
+        static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+        // delimiter ',' - CSV (RFC 4180, кавычки по необходимости), '\t' - TSV
+        DelimitedWriter(const std::string& path, char delimiter);
+        ~DelimitedWriter();
+
+        DelimitedWriter(const DelimitedWriter&)            = delete;
+        DelimitedWriter& operator=(const DelimitedWriter&) = delete;
+
+        [[nodiscard]] bool IsOpen() const { return _file != nullptr; }
+
+        void Int(int64_t value);
+
+        // Десятичная запись с фиксированным количеством знаков после точки (с округлением)
+        void Fixed(double value, int digits);
+
+        void String(std::string_view value);
+
+        // Локальное время "YYYY.MM.DD HH:MM:SS", как в таблицах отчета; 0 - пустое поле
+        void Timestamp(time_t value);
+
+        void EndRow();
+
+        // Дозапись буфера и закрытие файла; false - ошибка записи
+        bool Close();
+
+        [[nodiscard]] uint64_t Bytes() const { return _bytes; }
+
+        [[nodiscard]] uint64_t Rows() const { return _rows; }
+
+    private:
+        // Самое длинное поле, форматируемое прямо в буфер (числа и даты)
+        static constexpr size_t MAX_FIELD_SIZE = 64;
+
+        void BeginField();
+        void Reserve(size_t size);
+        void Flush();
+
+        std::FILE*              _file;
+        char                    _delimiter;
+        std::unique_ptr<char[]> _buffer;
+        size_t                  _capacity     = BUFFER_SIZE;
+        size_t                  _size         = 0;
+        bool                    _is_row_start = true;
+        bool                    _is_failed    = false;
+        uint64_t                _bytes        = 0;
+        uint64_t                _rows         = 0;
+    };
+} // namespace utils
@@ -0,0 +1,66 @@
+#include "NodeBuilder.h"
+
+namespace utils {
+    using rapidjson::StringRef;
+    using rapidjson::Value;
+
+    NodeBuilder::NodeBuilder(const char* type, Allocator& allocator)
+        : _allocator(allocator), _node(rapidjson::kObjectType), _props(rapidjson::kObjectType),
+          _children(rapidjson::kArrayType) {
+        _node.AddMember("type", StringRef(type), _allocator);
+    }
+
+    NodeBuilder& NodeBuilder::Prop(const char* key, const char* value) {
+        _props.AddMember(StringRef(key), StringRef(value), _allocator);
+        return *this;
+    }
+
+    NodeBuilder& NodeBuilder::Prop(const char* key, const std::string& value) {
+        _props.AddMember(
+            StringRef(key), Value(value.c_str(), value.size(), _allocator), _allocator);
+        return *this;
+    }
+
+    NodeBuilder& NodeBuilder::Prop(const char* key, double value) {
+        _props.AddMember(StringRef(key), Value(value), _allocator);
+        return *this;
+    }
+
+    NodeBuilder& NodeBuilder::Prop(const char* key, bool value) {
+        _props.AddMember(StringRef(key), Value(value), _allocator);
+        return *this;
+    }
+
+    NodeBuilder& NodeBuilder::Prop(const char* key, Value&& value) {
+        _props.AddMember(StringRef(key), value, _allocator);
+        return *this;
+    }
+
+    NodeBuilder& NodeBuilder::Props(Value&& props) {
+        _props = std::move(props);
+        return *this;
+    }
+
+    NodeBuilder& NodeBuilder::Child(Value&& child) {
+        _children.PushBack(child, _allocator);
+        return *this;
+    }
+
+    NodeBuilder& NodeBuilder::Child(const ast::Node& node) {
+        Value child(rapidjson::kObjectType);
+        ast::to_json(node, child, _allocator);
+        return Child(std::move(child));
+    }
+
+    Value NodeBuilder::Build() {
+        if (!_props.ObjectEmpty()) {
+            _node.AddMember("props", _props, _allocator);
+        }
+
+        if (!_children.Empty()) {
+            _node.AddMember("children", _children, _allocator);
+        }
+
+        return std::move(_node);
+    }
+} // namespace utils
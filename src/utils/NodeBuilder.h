@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+#include "ast/Ast.hpp"
+#include <rapidjson/document.h>
+
+namespace utils {
+    // Построитель узла UI {type, props, children} прямо в rapidjson::Value ответа.
+    // Ключи и строковые литералы не копируются, динамические строки копируются
+    // один раз в аллокатор ответа. DSL ast остается для небольших статичных фрагментов.
+    class NodeBuilder {
+    public:
+        using Allocator = rapidjson::Document::AllocatorType;
+
+        NodeBuilder(const char* type, Allocator& allocator);
+
+        // value - только строковый литерал (хранится по ссылке)
+        NodeBuilder& Prop(const char* key, const char* value);
+        NodeBuilder& Prop(const char* key, const std::string& value);
+        NodeBuilder& Prop(const char* key, double value);
+        NodeBuilder& Prop(const char* key, bool value);
+        NodeBuilder& Prop(const char* key, rapidjson::Value&& value);
+        // Готовый объект props целиком (например, props таблицы из TableBuilder)
+        NodeBuilder& Props(rapidjson::Value&& props);
+
+        NodeBuilder& Child(rapidjson::Value&& child);
+        NodeBuilder& Child(NodeBuilder& child) { return Child(child.Build()); }
+        NodeBuilder& Child(NodeBuilder&& child) { return Child(child.Build()); }
+        NodeBuilder& Child(const ast::Node& node);
+
+        // Готовый узел; построитель после вызова пуст
+        rapidjson::Value Build();
+
+    private:
+        Allocator&       _allocator;
+        rapidjson::Value _node;
+        rapidjson::Value _props;
+        rapidjson::Value _children;
+    };
+} // namespace utils
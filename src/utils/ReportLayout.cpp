@@ -0,0 +1,151 @@
+#include "ReportLayout.h"
+
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+#include "NodeBuilder.h"
+#include "Utils.h"
+
+namespace utils {
+    using rapidjson::Value;
+
+    namespace {
+        Value Heading(const char* type, const char* title, ReportLayout::Allocator& allocator) {
+            return NodeBuilder(type, allocator)
+                .Child(NodeBuilder("#text", allocator).Prop("value", title))
+                .Build();
+        }
+
+        Value ChartLine(const char*              data_key,
+                        const char*              stroke,
+                        ReportLayout::Allocator& allocator) {
+            return NodeBuilder("Recharts.Line", allocator)
+                .Prop("dataKey", data_key)
+                .Prop("stroke", stroke)
+                .Prop("type", "monotone")
+                .Build();
+        }
+
+        // Линейный график по дням; данные - слот props.data
+        Value LineChart(std::initializer_list<std::pair<const char*, const char*>> lines,
+                        ReportLayout::Allocator&                                   allocator) {
+            NodeBuilder chart("Recharts.LineChart", allocator);
+            chart.Prop("data", Value(rapidjson::kArrayType))
+                .Child(NodeBuilder("Recharts.XAxis", allocator).Prop("dataKey", "day"))
+                .Child(NodeBuilder("Recharts.YAxis", allocator))
+                .Child(NodeBuilder("Recharts.Tooltip", allocator))
+                .Child(NodeBuilder("Recharts.Legend", allocator));
+
+            for (const auto& [data_key, stroke] : lines) {
+                chart.Child(ChartLine(data_key, stroke, allocator));
+            }
+
+            return NodeBuilder("Recharts.ResponsiveContainer", allocator)
+                .Prop("width", "100%")
+                .Prop("height", 300.0)
+                .Child(chart)
+                .Build();
+        }
+
+        Value PieChart(ReportLayout::Allocator& allocator) {
+            return NodeBuilder("Recharts.ResponsiveContainer", allocator)
+                .Prop("width", "100%")
+                .Prop("height", 300.0)
+                .Child(NodeBuilder("Recharts.PieChart", allocator)
+                           .Child(NodeBuilder("Recharts.Tooltip", allocator))
+                           .Child(NodeBuilder("Recharts.Legend", allocator))
+                           .Child(NodeBuilder("Recharts.Pie", allocator)
+                                      .Prop("dataKey", "value")
+                                      .Prop("nameKey", "name")
+                                      .Prop("data", Value(rapidjson::kArrayType))
+                                      .Prop("cx", "50%")
+                                      .Prop("cy", "50%")
+                                      .Prop("outerRadius", 100.0)
+                                      .Prop("label", true)
+                                      .Child(NodeBuilder("Recharts.Cell", allocator)
+                                                 .Prop("fill", "#4A90E2")) // profit
+                                      .Child(NodeBuilder("Recharts.Cell", allocator)
+                                                 .Prop("fill", "#7ED321")))) // lose
+                .Build();
+        }
+
+        // Таблица; props целиком - слот
+        Value Table(ReportLayout::Allocator& allocator) {
+            Value table(rapidjson::kObjectType);
+            table.AddMember("type", "Table", allocator);
+            table.AddMember("props", Value(rapidjson::kObjectType), allocator);
+            return table;
+        }
+    } // namespace
+
+    const ReportLayout& ReportLayout::Instance() {
+        static const ReportLayout layout;
+        return layout;
+    }
+
+    ReportLayout::ReportLayout() {
+        Allocator&  allocator = _skeleton.GetAllocator();
+        NodeBuilder report("Column", allocator);
+        size_t      children_count = 0;
+
+        const auto add = [&report, &children_count](Value&& node) {
+            report.Child(std::move(node));
+            return children_count++;
+        };
+
+        // Путь слота: дочерний узел отчета внутри модального окна CreateUI
+        const auto bind = [this](ReportSlot slot, size_t child, const char* path) {
+            const std::string pointer =
+                "/ui/modal/content/0/children/" + std::to_string(child) + path;
+            _slots[static_cast<size_t>(slot)] = rapidjson::Pointer(pointer.c_str());
+        };
+
+        add(Heading("h1", "Daily Trades Report", allocator));
+
+        add(Heading("h2", "Profit and Loss of Clients, USD", allocator));
+        bind(ReportSlot::PnlChartData,
+             add(LineChart({{"profit", "#4A90E2"}, {"loss", "#7ED321"}, {"profit/loss", "#F5A623"}},
+                           allocator)),
+             "/children/0/props/data");
+
+        add(Heading("h2", "Client Trades Count", allocator));
+        bind(ReportSlot::TradesCountChartData,
+             add(LineChart({{"profit", "#4A90E2"}, {"loss", "#7ED321"}}, allocator)),
+             "/children/0/props/data");
+
+        add(Heading("h2", "Top Close Profit Orders", allocator));
+        bind(ReportSlot::TopCloseProfitTable, add(Table(allocator)), "/props");
+
+        add(Heading("h2", "Top Close Loss Orders", allocator));
+        bind(ReportSlot::TopCloseLossTable, add(Table(allocator)), "/props");
+
+        add(Heading("h2", "All Deals", allocator));
+        bind(ReportSlot::AllDealsTable, add(Table(allocator)), "/props");
+
+        add(Heading("h2", "Total Profit/Loss of Current Client Positions, USD (%)", allocator));
+        bind(ReportSlot::OpenPositionsPieData,
+             add(PieChart(allocator)),
+             "/children/0/children/2/props/data");
+
+        add(Heading("h2", "Top Open Profit Orders", allocator));
+        bind(ReportSlot::TopOpenProfitTable, add(Table(allocator)), "/props");
+
+        add(Heading("h2", "Top Open Loss Orders", allocator));
+        bind(ReportSlot::TopOpenLossTable, add(Table(allocator)), "/props");
+
+        CreateUI(report.Build(), _skeleton, allocator);
+    }
+
+    void ReportLayout::Instantiate(Value& response, Allocator& allocator) const {
+        // Строки каркаса - литералы, копируются только узлы
+        response.CopyFrom(_skeleton, allocator);
+    }
+
+    void ReportLayout::Fill(Value& response, ReportSlot slot, Value&& value) const {
+        Value* target = _slots[static_cast<size_t>(slot)].Get(response);
+        if (target != nullptr) {
+            *target = std::move(value);
+        }
+    }
+} // namespace utils
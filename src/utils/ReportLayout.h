@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <rapidjson/document.h>
+#include <rapidjson/pointer.h>
+
+namespace utils {
+    // Места ответа, заполняемые данными конкретного отчета
+    enum class ReportSlot {
+        PnlChartData,
+        TradesCountChartData,
+        TopCloseProfitTable,
+        TopCloseLossTable,
+        AllDealsTable,
+        OpenPositionsPieData,
+        TopOpenProfitTable,
+        TopOpenLossTable,
+        Count
+    };
+
+    // Неизменная часть ответа: модальное окно, заголовки, контейнеры и оси графиков.
+    // Строится один раз при загрузке плагина из строковых литералов, поэтому копия
+    // в ответ не копирует ни одной строки - запрос только подставляет данные в слоты
+    class ReportLayout {
+    public:
+        using Allocator = rapidjson::Document::AllocatorType;
+
+        static const ReportLayout& Instance();
+
+        // Каркас ответа с пустыми слотами
+        void Instantiate(rapidjson::Value& response, Allocator& allocator) const;
+
+        // Данные слота: массив данных графика или props таблицы
+        void Fill(rapidjson::Value& response, ReportSlot slot, rapidjson::Value&& value) const;
+
+    private:
+        ReportLayout();
+
+        rapidjson::Document                                                   _skeleton;
+        std::array<rapidjson::Pointer, static_cast<size_t>(ReportSlot::Count)> _slots;
+    };
+} // namespace utils
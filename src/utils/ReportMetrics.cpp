@@ -0,0 +1,84 @@
+#include "ReportMetrics.h"
+
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace utils {
+    namespace {
+        double ToMs(ReportMetrics::Clock::duration duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        }
+    } // namespace
+
+    void ReportMetrics::ScopedStage::Stop() {
+        if (_metrics == nullptr) {
+            return;
+        }
+
+        _metrics->AddStage(_name, Clock::now() - _start);
+        _metrics = nullptr;
+    }
+
+    void ReportMetrics::AddStage(const char* name, Clock::duration duration) {
+        for (auto& [stage_name, stage_duration] : _stages) {
+            if (std::strcmp(stage_name, name) == 0) {
+                stage_duration += duration;
+                return;
+            }
+        }
+
+        _stages.emplace_back(name, duration);
+    }
+
+    void ReportMetrics::AddCounter(const char* name, uint64_t value) {
+        for (auto& [counter_name, counter_value] : _counters) {
+            if (std::strcmp(counter_name, name) == 0) {
+                counter_value += value;
+                return;
+            }
+        }
+
+        _counters.emplace_back(name, value);
+    }
+
+    double ReportMetrics::TotalMs() const { return ToMs(Clock::now() - _start); }
+
+    std::string ReportMetrics::Format() const {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(3) << "total=" << TotalMs() << "ms";
+
+        for (const auto& [name, duration] : _stages) {
+            oss << ' ' << name << '=' << ToMs(duration) << "ms";
+        }
+
+        oss << ';';
+
+        for (const auto& [name, value] : _counters) {
+            oss << ' ' << name << '=' << value;
+        }
+
+        return oss.str();
+    }
+
+    rapidjson::Value ReportMetrics::ToJson(rapidjson::Document::AllocatorType& allocator) const {
+        using rapidjson::StringRef;
+        using rapidjson::Value;
+
+        Value stages(rapidjson::kObjectType);
+        for (const auto& [name, duration] : _stages) {
+            stages.AddMember(StringRef(name), ToMs(duration), allocator);
+        }
+
+        Value counters(rapidjson::kObjectType);
+        for (const auto& [name, value] : _counters) {
+            counters.AddMember(StringRef(name), static_cast<uint64_t>(value), allocator);
+        }
+
+        Value timings(rapidjson::kObjectType);
+        timings.AddMember("total_ms", TotalMs(), allocator);
+        timings.AddMember("stages_ms", stages, allocator);
+        timings.AddMember("counters", counters, allocator);
+        return timings;
+    }
+} // namespace utils
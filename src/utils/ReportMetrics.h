@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <rapidjson/document.h>
+
+namespace utils {
+    // Длительности этапов отчета и счетчики. Замер - два вызова steady_clock на этап,
+    // поэтому сбор включен всегда; имена этапов и счетчиков - строковые литералы
+    class ReportMetrics {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // Замер этапа до Stop() или до выхода из области видимости
+        class ScopedStage {
+        public:
+            ScopedStage(ReportMetrics& metrics, const char* name)
+                : _metrics(&metrics), _name(name), _start(Clock::now()) {}
+
+            ScopedStage(const ScopedStage&)            = delete;
+            ScopedStage& operator=(const ScopedStage&) = delete;
+
+            ~ScopedStage() { Stop(); }
+
+            void Stop();
+
+        private:
+            ReportMetrics*    _metrics;
+            const char*       _name;
+            Clock::time_point _start;
+        };
+
+        ReportMetrics() : _start(Clock::now()) {}
+
+        [[nodiscard]] ScopedStage Measure(const char* name) { return {*this, name}; }
+
+        // Повторный замер этапа с тем же именем суммируется
+        void AddStage(const char* name, Clock::duration duration);
+
+        void AddCounter(const char* name, uint64_t value);
+
+        // Время с создания объекта
+        [[nodiscard]] double TotalMs() const;
+
+        // "total=12.345ms fetch=...; closed_trades=... ..."
+        [[nodiscard]] std::string Format() const;
+
+        // {"total_ms": ..., "stages_ms": {...}, "counters": {...}}
+        [[nodiscard]] rapidjson::Value ToJson(rapidjson::Document::AllocatorType& allocator) const;
+
+    private:
+        Clock::time_point                                    _start;
+        std::vector<std::pair<const char*, Clock::duration>> _stages;
+        std::vector<std::pair<const char*, uint64_t>>        _counters;
+    };
+} // namespace utils
@@ -0,0 +1,227 @@
+#include "SimdKernels.h"
+
+#include <cmath>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DAILY_TRADES_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace utils::simd {
+    namespace {
+        using SumProfitLossKernel = ProfitLossSums (*)(const double*, const uint8_t*, size_t);
+        using CountPositiveKernel = size_t (*)(const double*, size_t);
+
+        struct Kernels {
+            KernelVariant       variant;
+            SumProfitLossKernel sum_profit_loss;
+            CountPositiveKernel count_positive;
+        };
+
+        // ---------- Scalar ----------
+
+        ProfitLossSums SumProfitLossScalar(const double* values, const uint8_t* mask, size_t size) {
+            ProfitLossSums sums;
+            for (size_t i = 0; i < size; ++i) {
+                const double value = mask[i] ? values[i] : 0.0;
+                sums.profit += value > 0.0 ? value : 0.0;
+                sums.loss += value < 0.0 ? value : 0.0;
+            }
+            return sums;
+        }
+
+        size_t CountPositiveScalar(const double* values, size_t size) {
+            size_t count = 0;
+            for (size_t i = 0; i < size; ++i) {
+                count += values[i] > 0.0;
+            }
+            return count;
+        }
+
+#ifdef DAILY_TRADES_X86_KERNELS
+        // ---------- AVX2 ----------
+
+        __attribute__((target("avx2"))) ProfitLossSums
+        SumProfitLossAvx2(const double* values, const uint8_t* mask, size_t size) {
+            const __m256d zero   = _mm256_setzero_pd();
+            __m256d       profit = zero;
+            __m256d       loss   = zero;
+
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4) {
+                int32_t mask_bytes;
+                __builtin_memcpy(&mask_bytes, mask + i, sizeof(mask_bytes));
+
+                const __m256i lane_mask = _mm256_cmpgt_epi64(
+                    _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(mask_bytes)), _mm256_setzero_si256());
+                const __m256d value =
+                    _mm256_and_pd(_mm256_loadu_pd(values + i), _mm256_castsi256_pd(lane_mask));
+
+                profit = _mm256_add_pd(profit, _mm256_max_pd(value, zero));
+                loss   = _mm256_add_pd(loss, _mm256_min_pd(value, zero));
+            }
+
+            alignas(32) double profit_lanes[4];
+            alignas(32) double loss_lanes[4];
+            _mm256_store_pd(profit_lanes, profit);
+            _mm256_store_pd(loss_lanes, loss);
+
+            ProfitLossSums sums = SumProfitLossScalar(values + i, mask + i, size - i);
+            sums.profit +=
+                (profit_lanes[0] + profit_lanes[1]) + (profit_lanes[2] + profit_lanes[3]);
+            sums.loss += (loss_lanes[0] + loss_lanes[1]) + (loss_lanes[2] + loss_lanes[3]);
+            return sums;
+        }
+
+        __attribute__((target("avx2,popcnt"))) size_t CountPositiveAvx2(const double* values,
+                                                                         size_t        size) {
+            const __m256d zero  = _mm256_setzero_pd();
+            size_t        count = 0;
+
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4) {
+                const __m256d positive =
+                    _mm256_cmp_pd(_mm256_loadu_pd(values + i), zero, _CMP_GT_OQ);
+                count += __builtin_popcount(_mm256_movemask_pd(positive));
+            }
+
+            return count + CountPositiveScalar(values + i, size - i);
+        }
+
+        // ---------- AVX-512 ----------
+
+        __attribute__((target("avx512f"))) ProfitLossSums
+        SumProfitLossAvx512(const double* values, const uint8_t* mask, size_t size) {
+            const __m512d zero   = _mm512_setzero_pd();
+            __m512d       profit = zero;
+            __m512d       loss   = zero;
+
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                long long mask_bytes;
+                __builtin_memcpy(&mask_bytes, mask + i, sizeof(mask_bytes));
+
+                const __mmask8 lane_mask =
+                    _mm512_test_epi64_mask(_mm512_cvtepu8_epi64(_mm_cvtsi64_si128(mask_bytes)),
+                                           _mm512_set1_epi64(0xFF));
+                const __m512d value = _mm512_maskz_loadu_pd(lane_mask, values + i);
+
+                profit = _mm512_add_pd(profit, _mm512_max_pd(value, zero));
+                loss   = _mm512_add_pd(loss, _mm512_min_pd(value, zero));
+            }
+
+            ProfitLossSums sums = SumProfitLossScalar(values + i, mask + i, size - i);
+            sums.profit += _mm512_reduce_add_pd(profit);
+            sums.loss += _mm512_reduce_add_pd(loss);
+            return sums;
+        }
+
+        __attribute__((target("avx512f,popcnt"))) size_t CountPositiveAvx512(const double* values,
+                                                                             size_t        size) {
+            const __m512d zero  = _mm512_setzero_pd();
+            size_t        count = 0;
+
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                const __mmask8 positive =
+                    _mm512_cmp_pd_mask(_mm512_loadu_pd(values + i), zero, _CMP_GT_OQ);
+                count += __builtin_popcount(positive);
+            }
+
+            return count + CountPositiveScalar(values + i, size - i);
+        }
+#endif
+
+        constexpr Kernels SCALAR_KERNELS{
+            KernelVariant::Scalar, SumProfitLossScalar, CountPositiveScalar};
+
+        std::vector<Kernels> SupportedKernels() {
+            std::vector<Kernels> kernels{SCALAR_KERNELS};
+
+#ifdef DAILY_TRADES_X86_KERNELS
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                kernels.push_back({KernelVariant::Avx2, SumProfitLossAvx2, CountPositiveAvx2});
+            }
+            if (__builtin_cpu_supports("avx512f")) {
+                kernels.push_back(
+                    {KernelVariant::Avx512, SumProfitLossAvx512, CountPositiveAvx512});
+            }
+#endif
+
+            return kernels;
+        }
+
+        const Kernels& SelectKernels() {
+            static const Kernels kernels = SupportedKernels().back();
+            return kernels;
+        }
+
+        bool IsClose(double a, double b) {
+            return a == b ||
+                   std::fabs(a - b) <= 1e-9 * std::fmax(1.0, std::fmax(std::fabs(a), std::fabs(b)));
+        }
+    } // namespace
+
+    ProfitLossSums SumProfitLoss(const double* values, const uint8_t* mask, size_t size) {
+        return SelectKernels().sum_profit_loss(values, mask, size);
+    }
+
+    size_t CountPositive(const double* values, size_t size) {
+        return SelectKernels().count_positive(values, size);
+    }
+
+    KernelVariant ActiveVariant() {
+        return SelectKernels().variant;
+    }
+
+    const char* VariantName(KernelVariant variant) {
+        switch (variant) {
+            case KernelVariant::Scalar: return "scalar";
+            case KernelVariant::Avx2: return "avx2";
+            case KernelVariant::Avx512: return "avx512";
+        }
+        return "scalar";
+    }
+
+    bool CrossCheckKernels(const double* values, const uint8_t* mask, size_t size) {
+        const ProfitLossSums expected       = SumProfitLossScalar(values, mask, size);
+        const size_t         expected_count = CountPositiveScalar(values, size);
+
+        for (const Kernels& kernels : SupportedKernels()) {
+            const ProfitLossSums actual = kernels.sum_profit_loss(values, mask, size);
+
+            if (!IsClose(expected.profit, actual.profit) || !IsClose(expected.loss, actual.loss) ||
+                expected_count != kernels.count_positive(values, size)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool CrossCheckKernels() {
+        // Детерминированные данные: разные знаки, нули, хвосты не кратные ширине вектора
+        std::vector<double>  values(1031);
+        std::vector<uint8_t> mask(values.size());
+        uint64_t             state = 0x9E3779B97F4A7C15ull;
+
+        for (size_t i = 0; i < values.size(); ++i) {
+            state     = state * 6364136223846793005ull + 1442695040888963407ull;
+            const int64_t cents = static_cast<int64_t>(state >> 33) % 200000 - 100000;
+
+            values[i] = static_cast<double>(cents) / 100.0;
+            mask[i]   = (state >> 17) % 5 != 0;
+        }
+        values[7] = 0.0;
+
+        for (const size_t size : {size_t(0), size_t(3), size_t(8), size_t(17), values.size()}) {
+            if (!CrossCheckKernels(values.data(), mask.data(), size)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+} // namespace utils::simd
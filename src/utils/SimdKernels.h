@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace utils::simd {
+    // Суммы положительных и отрицательных значений
+    struct ProfitLossSums {
+        double profit = 0.0;
+        double loss   = 0.0; // отрицательное число или 0
+    };
+
+    enum class KernelVariant { Scalar, Avx2, Avx512 };
+
+    // Сумма max(x, 0) и min(x, 0) по значениям, у которых mask[i] != 0
+    ProfitLossSums SumProfitLoss(const double* values, const uint8_t* mask, size_t size);
+
+    // Количество значений > 0
+    size_t CountPositive(const double* values, size_t size);
+
+    // Вариант ядер, выбранный по возможностям процессора
+    KernelVariant ActiveVariant();
+
+    const char* VariantName(KernelVariant variant);
+
+    // Сверка всех поддерживаемых процессором вариантов со скалярной реализацией
+    // на переданных значениях
+    bool CrossCheckKernels(const double* values, const uint8_t* mask, size_t size);
+
+    // То же на встроенном наборе данных
+    bool CrossCheckKernels();
+} // namespace utils::simd
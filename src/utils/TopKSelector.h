@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace utils {
+    // Потоковый отбор K лучших строк: хранится только K пар (ключ, индекс строки),
+    // без копий сделок.
+    // Better задает порядок ключей (std::greater - максимальные, std::less - минимальные),
+    // при равных ключах выигрывает меньший индекс строки, поэтому результат детерминирован.
+    template <typename Better>
+    class TopKSelector {
+    public:
+        struct Entry {
+            double key;
+            size_t row;
+        };
+
+        explicit TopKSelector(size_t k = 10) : _k(k) { _heap.reserve(k); }
+
+        void Push(double key, size_t row) {
+            if (_k == 0) {
+                return;
+            }
+
+            const Entry entry{key, row};
+
+            if (_heap.size() < _k) {
+                _heap.push_back(entry);
+                std::push_heap(_heap.begin(), _heap.end(), IsBetter);
+            } else if (IsBetter(entry, _heap.front())) {
+                // На вершине кучи - худший из отобранных, он и вытесняется
+                std::pop_heap(_heap.begin(), _heap.end(), IsBetter);
+                _heap.back() = entry;
+                std::push_heap(_heap.begin(), _heap.end(), IsBetter);
+            }
+        }
+
+        // Слияние с селектором другого потока/диапазона
+        void Merge(const TopKSelector& other) {
+            for (const Entry& entry : other._heap) {
+                Push(entry.key, entry.row);
+            }
+        }
+
+        // Индексы строк от лучшей к худшей
+        [[nodiscard]] std::vector<size_t> SortedRows() const {
+            std::vector<Entry> entries = _heap;
+            std::sort(entries.begin(), entries.end(), IsBetter);
+
+            std::vector<size_t> rows;
+            rows.reserve(entries.size());
+            for (const Entry& entry : entries) {
+                rows.push_back(entry.row);
+            }
+            return rows;
+        }
+
+        [[nodiscard]] size_t Size() const { return _heap.size(); }
+
+    private:
+        static bool IsBetter(const Entry& a, const Entry& b) {
+            if (a.key != b.key) {
+                return Better()(a.key, b.key);
+            }
+            return a.row < b.row;
+        }
+
+        size_t             _k;
+        std::vector<Entry> _heap;
+    };
+
+    using TopProfitSelector = TopKSelector<std::greater<double>>;
+    using TopLossSelector   = TopKSelector<std::less<double>>;
+} // namespace utils
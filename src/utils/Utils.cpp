@@ -4,12 +4,18 @@ namespace utils {
     void CreateUI(const ast::Node&                    node,
                   rapidjson::Value&                   response,
                   rapidjson::Document::AllocatorType& allocator) {
-        // Content
         Value node_object(kObjectType);
         to_json(node, node_object, allocator);
 
+        CreateUI(std::move(node_object), response, allocator);
+    }
+
+    void CreateUI(rapidjson::Value&&                  content,
+                  rapidjson::Value&                   response,
+                  rapidjson::Document::AllocatorType& allocator) {
+        // Content
         Value content_array(kArrayType);
-        content_array.PushBack(node_object, allocator);
+        content_array.PushBack(content, allocator);
 
         // Header
         Value header_array(kArrayType);
@@ -94,6 +100,16 @@ namespace utils {
         response.AddMember("ui", ui_object, allocator);
     }
 
+    std::chrono::seconds GetEnvSeconds(const char* name, std::chrono::seconds default_value) {
+        const char* value = std::getenv(name);
+        return value == nullptr ? default_value : std::chrono::seconds(std::atol(value));
+    }
+
+    size_t GetEnvSize(const char* name, size_t default_value) {
+        const char* value = std::getenv(name);
+        return value == nullptr ? default_value : static_cast<size_t>(std::atoll(value));
+    }
+
     std::string FormatTimestampToString(const time_t& timestamp, const std::string& format) {
         std::tm tm{};
         localtime_r(&timestamp, &tm);
@@ -108,14 +124,70 @@ namespace utils {
         return std::trunc(value * factor) / factor;
     }
 
-    std::string GetGroupCurrencyByName(const std::vector<GroupRecord>& group_vector,
-                                       const std::string&              group_name) {
-        for (const auto& group : group_vector) {
-            if (group.group == group_name) {
-                return group.currency;
+    // Шаблон одного элемента маски: '*' - любая последовательность символов
+    static bool MatchWildcard(const char* pattern,
+                              const char* pattern_end,
+                              const char* value,
+                              const char* value_end) {
+        const char* star_pattern = nullptr;
+        const char* star_value   = nullptr;
+
+        while (value != value_end) {
+            if (pattern != pattern_end && *pattern == '*') {
+                star_pattern = ++pattern;
+                star_value   = value;
+            } else if (pattern != pattern_end && *pattern == *value) {
+                ++pattern;
+                ++value;
+            } else if (star_pattern != nullptr) {
+                pattern = star_pattern;
+                value   = ++star_value;
+            } else {
+                return false;
+            }
+        }
+
+        while (pattern != pattern_end && *pattern == '*') {
+            ++pattern;
+        }
+
+        return pattern == pattern_end;
+    }
+
+    bool MatchGroupMask(const std::string& group_mask, const std::string& group_name) {
+        // Маска - список шаблонов через запятую, '!' в начале шаблона исключает группу
+        bool        matched = false;
+        const char* begin   = group_mask.data();
+        const char* end     = begin + group_mask.size();
+
+        while (begin < end) {
+            const char* token_end = std::find(begin, end, ',');
+            const char* token     = begin;
+
+            while (token < token_end && *token == ' ') {
+                ++token;
             }
+
+            const bool is_exclusion = token < token_end && *token == '!';
+            if (is_exclusion) {
+                ++token;
+            }
+
+            if (token < token_end &&
+                MatchWildcard(token,
+                              token_end,
+                              group_name.data(),
+                              group_name.data() + group_name.size())) {
+                if (is_exclusion) {
+                    return false;
+                }
+                matched = true;
+            }
+
+            begin = token_end + 1;
         }
-        return "N/A"; // группа не найдена - валюта не определена
+
+        return matched;
     }
 
     int CalculateTimestampForTwoWeeksAgo(const int& timestamp) {
@@ -123,6 +195,29 @@ namespace utils {
         return timestamp - two_weeks_interval;
     }
 
+    time_t CalculateDayStart(const time_t& time) {
+        std::tm tm{};
+        localtime_r(&time, &tm);
+
+        tm.tm_hour  = 0;
+        tm.tm_min   = 0;
+        tm.tm_sec   = 0;
+        tm.tm_isdst = -1;
+        return std::mktime(&tm);
+    }
+
+    time_t CalculateNextDayStart(const time_t& day_start) {
+        std::tm tm{};
+        localtime_r(&day_start, &tm);
+
+        tm.tm_mday += 1;
+        tm.tm_hour  = 0;
+        tm.tm_min   = 0;
+        tm.tm_sec   = 0;
+        tm.tm_isdst = -1;
+        return std::mktime(&tm);
+    }
+
     std::string FormatDateForChart(const time_t& time) {
         std::tm tm{};
 #ifdef _WIN32
@@ -135,144 +230,97 @@ namespace utils {
         return oss.str();
     }
 
-    JSONArray CreatePnlChartData(const std::vector<UsdConvertedTrade>& trades) {
-        std::map<std::string, PnlDataPoint> daily_data;
+    size_t CalculateJsonSize(const rapidjson::Value& value) {
+        // Поток для rapidjson::Writer, который только считает записанные символы
+        struct CountingStream {
+            using Ch = char;
 
-        for (const auto& trade : trades) {
-            std::string day = FormatDateForChart(trade.close_time);
+            void Put(Ch) { ++size; }
+            void Flush() {}
 
-            auto& data_point = daily_data[day];
-            data_point.date  = day;
+            size_t size = 0;
+        };
 
-            if (trade.usd_profit > 0) {
-                data_point.profit += trade.usd_profit;
-            } else {
-                data_point.loss += trade.usd_profit;
-            }
+        CountingStream                    stream;
+        rapidjson::Writer<CountingStream> writer(stream);
+        value.Accept(writer);
+        return stream.size;
+    }
 
-            data_point.total += trade.usd_profit;
-        }
+    Value CreatePnlChartData(const std::map<time_t, DailyTradesAggregate>& daily_data,
+                             rapidjson::Document::AllocatorType&           allocator) {
+        Value chart_data(kArrayType);
+        chart_data.Reserve(static_cast<rapidjson::SizeType>(daily_data.size()), allocator);
 
-        std::vector<PnlDataPoint> data_points;
-        for (const auto& [date, data_point] : daily_data) {
-            data_points.push_back(data_point);
-        }
+        for (const auto& [day_start, data_point] : daily_data) {
+            if (data_point.profit_count == 0 && data_point.loss_count == 0) {
+                continue;
+            }
 
-        std::sort(data_points.begin(),
-                  data_points.end(),
-                  [](const PnlDataPoint& a, const PnlDataPoint& b) { return a.date < b.date; });
+            const std::string day = FormatDateForChart(day_start);
 
-        JSONArray chart_data;
-        for (const auto& data_point : data_points) {
-            JSONObject point;
-            point["day"]         = JSONValue(data_point.date);
-            point["profit"]      = JSONValue(static_cast<double>(data_point.profit));
-            point["loss"]        = JSONValue(static_cast<double>(data_point.loss));
-            point["profit/loss"] = JSONValue(static_cast<double>(data_point.total));
+            Value point(kObjectType);
+            point.AddMember("day", Value(day.c_str(), day.size(), allocator), allocator);
+            point.AddMember("profit", TruncateDouble(data_point.profit, 2), allocator);
+            point.AddMember("loss", TruncateDouble(data_point.loss, 2), allocator);
+            point.AddMember("profit/loss", TruncateDouble(data_point.total, 2), allocator);
 
-            chart_data.emplace_back(point);
+            chart_data.PushBack(point, allocator);
         }
 
         return chart_data;
     }
 
-    JSONArray CreateTradesCountChartData(const std::vector<TradeRecord>& trades) {
-        std::map<std::string, TradesCountDataPoint> daily_data;
-
-        for (const auto& trade : trades) {
-            std::string day = FormatDateForChart(trade.close_time);
+    Value CreateTradesCountChartData(const std::map<time_t, DailyTradesAggregate>& daily_data,
+                                     rapidjson::Document::AllocatorType&           allocator) {
+        Value chart_data(kArrayType);
+        chart_data.Reserve(static_cast<rapidjson::SizeType>(daily_data.size()), allocator);
 
-            auto& data_point = daily_data[day];
-            data_point.date  = day;
-
-            if (trade.profit > 0) {
-                data_point.profit += 1;
-            } else {
-                data_point.loss += 1;
+        for (const auto& [day_start, data_point] : daily_data) {
+            if (data_point.profit_count == 0 && data_point.loss_count == 0) {
+                continue;
             }
-        }
-
-        std::vector<TradesCountDataPoint> data_points;
-        for (const auto& [date, data_point] : daily_data) {
-            data_points.push_back(data_point);
-        }
 
-        std::sort(data_points.begin(),
-                  data_points.end(),
-                  [](const TradesCountDataPoint& a, const TradesCountDataPoint& b) {
-                      return a.date < b.date;
-                  });
+            const std::string day = FormatDateForChart(day_start);
 
-        JSONArray chart_data;
-        for (const auto& data_point : data_points) {
-            JSONObject point;
-            point["day"]    = JSONValue(data_point.date);
-            point["profit"] = JSONValue(static_cast<double>(data_point.profit));
-            point["loss"]   = JSONValue(static_cast<double>(data_point.loss));
+            Value point(kObjectType);
+            point.AddMember("day", Value(day.c_str(), day.size(), allocator), allocator);
+            point.AddMember("profit", static_cast<double>(data_point.profit_count), allocator);
+            point.AddMember("loss", static_cast<double>(data_point.loss_count), allocator);
 
-            chart_data.emplace_back(point);
+            chart_data.PushBack(point, allocator);
         }
 
         return chart_data;
     }
 
-    JSONArray CreateOpenPositionsPieChartData(const std::vector<UsdConvertedTrade>& trades) {
-        double total_profit = 0.0;
-        double total_loss   = 0.0;
+    Value CreateOpenPositionsPieChartData(const OpenPositionsTotals&          totals,
+                                          rapidjson::Document::AllocatorType& allocator) {
+        const double total_profit = totals.profit;
+        const double total_loss   = totals.loss;
 
-        for (const auto& trade : trades) {
-            if (trade.usd_profit >= 0)
-                total_profit += trade.usd_profit;
-            else
-                total_loss += -trade.usd_profit; // убыток как положительное число
-        }
+        Value chart_data(kArrayType);
 
         double total = total_profit + total_loss;
         if (total == 0.0)
-            return JSONArray{}; // нет открытых позиций с P/L
-
-        JSONArray chart_data;
+            return chart_data; // нет открытых позиций с P/L
 
         auto round2 = [](double value) -> double { return std::round(value * 100.0) / 100.0; };
 
         if (total_profit > 0) {
-            JSONObject profit_point;
-            profit_point["name"]  = JSONValue("Profit");
-            profit_point["value"] = JSONValue(round2((total_profit / total) * 100.0));
-            chart_data.emplace_back(profit_point);
+            Value profit_point(kObjectType);
+            profit_point.AddMember("name", "Profit", allocator);
+            profit_point.AddMember("value", round2((total_profit / total) * 100.0), allocator);
+            chart_data.PushBack(profit_point, allocator);
         }
 
         if (total_loss > 0) {
-            JSONObject loss_point;
-            loss_point["name"]  = JSONValue("Loss");
-            loss_point["value"] = JSONValue(round2((total_loss / total) * 100.0));
-            chart_data.emplace_back(loss_point);
+            Value loss_point(kObjectType);
+            loss_point.AddMember("name", "Loss", allocator);
+            loss_point.AddMember("value", round2((total_loss / total) * 100.0), allocator);
+            chart_data.PushBack(loss_point, allocator);
         }
 
         return chart_data;
     }
-
-    std::vector<TradeRecord> CreateTopProfitOrdersVector(const std::vector<TradeRecord>& trades) {
-        std::vector<TradeRecord> result = trades;
-        size_t                   k      = std::min(result.size(), size_t(10));
-        std::partial_sort(
-            result.begin(),
-            result.begin() + k,
-            result.end(),
-            [](const TradeRecord& a, const TradeRecord& b) { return a.profit > b.profit; });
-        result.resize(k);
-        return result;
-    }
-
-    std::vector<TradeRecord> CreateTopLossOrdersVector(const std::vector<TradeRecord>& trades) {
-        std::vector<TradeRecord> result = trades;
-        size_t                   k      = std::min(result.size(), size_t(10));
-        std::partial_sort(
-            result.begin(),
-            result.begin() + k,
-            result.end(),
-            [](const TradeRecord& a, const TradeRecord& b) { return a.profit < b.profit; });
-        result.resize(k);
-        return result;
-    }
-} // namespace utils
\ No newline at end of file
+} // namespace utils
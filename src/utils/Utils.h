@@ -1,8 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <cstdlib>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
@@ -15,6 +17,7 @@
 #include "ast/Ast.hpp"
 #include "structures/PluginStructures.h"
 #include <rapidjson/document.h>
+#include <rapidjson/writer.h>
 
 using namespace ast;
 
@@ -23,25 +26,42 @@ namespace utils {
                   rapidjson::Value&                   response,
                   rapidjson::Document::AllocatorType& allocator);
 
+    // Контент уже собран в аллокаторе ответа (NodeBuilder) - перемещается без копирования
+    void CreateUI(rapidjson::Value&&                  content,
+                  rapidjson::Value&                   response,
+                  rapidjson::Document::AllocatorType& allocator);
+
+    // Значение переменной окружения или default_value, если переменная не задана
+    std::chrono::seconds GetEnvSeconds(const char* name, std::chrono::seconds default_value);
+
+    size_t GetEnvSize(const char* name, size_t default_value);
+
     std::string FormatTimestampToString(const time_t&      timestamp,
                                         const std::string& format = "%Y.%m.%d %H:%M:%S");
 
     double TruncateDouble(const double& value, const int& digits);
 
-    std::string GetGroupCurrencyByName(const std::vector<GroupRecord>& group_vector,
-                                       const std::string&              group_name);
+    bool MatchGroupMask(const std::string& group_mask, const std::string& group_name);
 
     int CalculateTimestampForTwoWeeksAgo(const int& timestamp);
 
-    std::string FormatDateForChart(const time_t& time);
+    time_t CalculateDayStart(const time_t& time);
 
-    JSONArray CreatePnlChartData(const std::vector<UsdConvertedTrade>& trades);
+    time_t CalculateNextDayStart(const time_t& day_start);
+
+    std::string FormatDateForChart(const time_t& time);
 
-    JSONArray CreateTradesCountChartData(const std::vector<TradeRecord>& trades);
+    // Размер значения в сериализованном JSON; текст не сохраняется, только считается
+    size_t CalculateJsonSize(const rapidjson::Value& value);
 
-    JSONArray CreateOpenPositionsPieChartData(const std::vector<UsdConvertedTrade>& trades);
+    // Данные графиков пишутся сразу в аллокатор ответа
+    rapidjson::Value CreatePnlChartData(const std::map<time_t, DailyTradesAggregate>& daily_data,
+                                        rapidjson::Document::AllocatorType&           allocator);
 
-    std::vector<TradeRecord> CreateTopProfitOrdersVector(const std::vector<TradeRecord>& trades);
+    rapidjson::Value
+    CreateTradesCountChartData(const std::map<time_t, DailyTradesAggregate>& daily_data,
+                               rapidjson::Document::AllocatorType&           allocator);
 
-    std::vector<TradeRecord> CreateTopLossOrdersVector(const std::vector<TradeRecord>& trades);
+    rapidjson::Value CreateOpenPositionsPieChartData(const OpenPositionsTotals&          totals,
+                                                     rapidjson::Document::AllocatorType& allocator);
 } // namespace utils
\ No newline at end of file
@@ -0,0 +1,71 @@
+// Сверка векторных ядер со скалярной реализацией на граничных входных данных.
+// Возвращает ненулевой код, если хотя бы один вариант ядер расходится со скалярным
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "utils/SimdKernels.h"
+
+namespace {
+    int failures = 0;
+
+    void Check(const std::string&          name,
+               const std::vector<double>&  values,
+               const std::vector<uint8_t>& mask) {
+        if (!utils::simd::CrossCheckKernels(values.data(), mask.data(), values.size())) {
+            std::cerr << "FAILED: " << name << " (" << values.size() << " values)" << std::endl;
+            ++failures;
+        }
+    }
+
+    // Значения со всеми знаками; каждое третье значение исключено маской
+    void MakeMixed(size_t size, std::vector<double>& values, std::vector<uint8_t>& mask) {
+        values.resize(size);
+        mask.resize(size);
+        for (size_t i = 0; i < size; ++i) {
+            values[i] = (i % 2 == 0 ? 1.0 : -1.0) * (static_cast<double>(i) + 0.25);
+            mask[i]   = i % 3 != 0;
+        }
+    }
+} // namespace
+
+int main() {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    std::vector<double>  values;
+    std::vector<uint8_t> mask;
+
+    Check("empty", values, mask);
+
+    // Все длины хвостов для векторов по 4 и по 8 значений
+    for (size_t size = 1; size <= 33; ++size) {
+        MakeMixed(size, values, mask);
+        Check("tail", values, mask);
+    }
+
+    Check("negative", std::vector<double>(19, -12.5), std::vector<uint8_t>(19, 1));
+    Check("zero", std::vector<double>(16, 0.0), std::vector<uint8_t>(16, 1));
+    Check("masked out", std::vector<double>(21, 7.0), std::vector<uint8_t>(21, 0));
+
+    MakeMixed(37, values, mask);
+    for (const size_t i : {0, 5, 8, 36}) {
+        values[i] = nan;
+    }
+    Check("nan", values, mask);
+
+    std::fill(mask.begin(), mask.end(), 1);
+    Check("nan unmasked", values, mask);
+
+    if (!utils::simd::CrossCheckKernels()) {
+        std::cerr << "FAILED: built-in data" << std::endl;
+        ++failures;
+    }
+
+    std::cout << "SIMD kernels: " << utils::simd::VariantName(utils::simd::ActiveVariant())
+              << ", " << (failures == 0 ? "passed" : "FAILED") << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}